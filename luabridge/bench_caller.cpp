@@ -0,0 +1,271 @@
+//
+// Caller benchmark: instructions and time per call from Lua for bound
+// functions of 1, 4 and 12 arguments, through the real binding path:
+// REGISTER_CFUNC_T for free functions and AddFunction for member functions.
+//
+// Built twice from this file: luabridge_bench_caller uses the variadic Caller
+// of include/core/caller.h, luabridge_bench_caller_unrolled
+// (-DBENCH_UNROLLED_CALLER) uses bench_caller_unrolled.h, the hand-unrolled
+// caller.h it replaced. Both bind the same functions of 0 to 12 arguments and
+// link the same liblua, so the difference of their text sizes is the cost of
+// the two Callers in one binding TU. "make bench_caller" runs both and prints
+// their sizes.
+//
+
+#ifdef BENCH_UNROLLED_CALLER
+// Same include guard as core/caller.h, every header below gets this one
+#include "core/lua_stack.h"
+#include "bench_caller_unrolled.h"
+#define CALLER_NAME "unrolled"
+#else
+#define CALLER_NAME "variadic"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "lua_bridge.h"
+
+using namespace luabridge;
+
+#ifdef BENCH_UNROLLED_CALLER
+// Only the unrolled Caller takes the parameter count first, fails if core/caller.h was used
+typedef Caller<0, int> UnrolledCallerCheck;
+#endif
+
+static const int N = 5000000;
+
+static int Arg0()
+{
+    return 0;
+}
+
+static int Arg1(int a)
+{
+    return a + 1;
+}
+
+static double Arg2(int a, double b)
+{
+    return a + b;
+}
+
+static double Arg3(int a, double b, const char *c)
+{
+    return a + b + c[0];
+}
+
+static double Arg4(int a, double b, const char *c, bool d)
+{
+    return a + b + c[0] + d;
+}
+
+static double Arg5(int a, double b, const char *c, bool d, int e)
+{
+    return a + b + c[0] + d + e;
+}
+
+static double Arg6(int a, double b, const char *c, bool d, int e, double f)
+{
+    return a + b + c[0] + d + e + f;
+}
+
+static double Arg7(int a, double b, const char *c, bool d, int e, double f, const char *g)
+{
+    return a + b + c[0] + d + e + f + g[0];
+}
+
+static double Arg8(int a, double b, const char *c, bool d, int e, double f, const char *g, bool h)
+{
+    return a + b + c[0] + d + e + f + g[0] + h;
+}
+
+static double Arg9(int a, double b, const char *c, bool d, int e, double f, const char *g, bool h, int i)
+{
+    return a + b + c[0] + d + e + f + g[0] + h + i;
+}
+
+static double Arg10(int a, double b, const char *c, bool d, int e, double f, const char *g, bool h, int i, double j)
+{
+    return a + b + c[0] + d + e + f + g[0] + h + i + j;
+}
+
+static double Arg11(int a, double b, const char *c, bool d, int e, double f, const char *g, bool h, int i, double j,
+                    const char *k)
+{
+    return a + b + c[0] + d + e + f + g[0] + h + i + j + k[0];
+}
+
+static double Arg12(int a, double b, const char *c, bool d, int e, double f, const char *g, bool h, int i, double j,
+                    const char *k, bool l)
+{
+    return a + b + c[0] + d + e + f + g[0] + h + i + j + k[0] + l;
+}
+
+class Object
+{
+public:
+    Object()
+        : m_base(1)
+    {
+    }
+
+    int Arg1(int a)
+    {
+        return m_base + a;
+    }
+
+    double Arg4(int a, double b, const char *c, bool d)
+    {
+        return m_base + a + b + c[0] + d;
+    }
+
+    double Arg12(int a, double b, const char *c, bool d, int e, double f, const char *g, bool h, int i, double j,
+                 const char *k, bool l) const
+    {
+        return m_base + a + b + c[0] + d + e + f + g[0] + h + i + j + k[0] + l;
+    }
+
+private:
+    int m_base;
+};
+
+/**
+ * Plain lua_CFunction, the cost of the Lua call itself
+ */
+static int Raw(lua_State *L)
+{
+    lua_pushinteger(L, lua_gettop(L));
+    return 1;
+}
+
+static void Register(LuaBridge &lua)
+{
+    BEGIN_REGISTER_CFUNC(lua)
+        REGISTER_CFUNC_T("Arg0", &Arg0)
+        REGISTER_CFUNC_T("Arg1", &Arg1)
+        REGISTER_CFUNC_T("Arg2", &Arg2)
+        REGISTER_CFUNC_T("Arg3", &Arg3)
+        REGISTER_CFUNC_T("Arg4", &Arg4)
+        REGISTER_CFUNC_T("Arg5", &Arg5)
+        REGISTER_CFUNC_T("Arg6", &Arg6)
+        REGISTER_CFUNC_T("Arg7", &Arg7)
+        REGISTER_CFUNC_T("Arg8", &Arg8)
+        REGISTER_CFUNC_T("Arg9", &Arg9)
+        REGISTER_CFUNC_T("Arg10", &Arg10)
+        REGISTER_CFUNC_T("Arg11", &Arg11)
+        REGISTER_CFUNC_T("Arg12", &Arg12)
+    END_REGISTER_CFUNC
+    lua.GetGlobalNamespace()
+        .BeginClass<Object>("Object", false)
+        .AddConstructor<void (*)()>()
+        .AddFunction("Arg1", &Object::Arg1)
+        .AddFunction("Arg4", &Object::Arg4)
+        .AddFunction("Arg12", &Object::Arg12)
+        .EndClass();
+    lua_register(lua.LuaState(), "Raw", &Raw);
+}
+
+/**
+ * User space instructions retired, -1 if perf events are not available
+ */
+class InstructionCounter
+{
+public:
+    InstructionCounter()
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~InstructionCounter()
+    {
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+    }
+
+    void Start()
+    {
+        if (m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    long long Stop()
+    {
+        long long count = -1;
+        if (m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+                count = -1;
+            }
+        }
+        return count;
+    }
+
+private:
+    int m_fd;
+};
+
+/**
+ * Run call N times in a Lua loop, o is a bound Object
+ */
+static void Run(lua_State *L, const char *name, int args, const char *call)
+{
+    char code[512];
+    snprintf(code, sizeof(code), "local o = Object() for i = 1, %d do %s end", N, call);
+    if (luaL_loadstring(L, code) != LUA_OK) {
+        printf("%s: %s\n", name, lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return;
+    }
+    InstructionCounter counter;
+    counter.Start();
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    int ret = lua_pcall(L, 0, 0, 0);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    long long instructions = counter.Stop();
+    if (ret != LUA_OK) {
+        printf("%s: %s\n", name, lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return;
+    }
+    if (instructions >= 0) {
+        printf("%-10s %-8s args %2d  %7.1f instructions/call  %6.1f ns/call\n",
+               CALLER_NAME, name, args, static_cast<double>(instructions) / N, ns / N);
+    }
+    else {
+        printf("%-10s %-8s args %2d  instructions n/a (no perf events)  %6.1f ns/call\n", CALLER_NAME, name, args, ns / N);
+    }
+}
+
+int main()
+{
+    LuaBridge lua;
+    Register(lua);
+    lua_State *L = lua.LuaState();
+
+    Run(L, "Raw", 1, "Raw(1)");
+    Run(L, "Raw", 4, "Raw(1, 2.5, 'x', true)");
+    Run(L, "Raw", 12, "Raw(1, 2.5, 'x', true, 1, 2.5, 'x', true, 1, 2.5, 'x', true)");
+    Run(L, "Arg", 1, "Arg1(1)");
+    Run(L, "Arg", 4, "Arg4(1, 2.5, 'x', true)");
+    Run(L, "Arg", 12, "Arg12(1, 2.5, 'x', true, 1, 2.5, 'x', true, 1, 2.5, 'x', true)");
+    Run(L, "Object", 1, "o:Arg1(1)");
+    Run(L, "Object", 4, "o:Arg4(1, 2.5, 'x', true)");
+    Run(L, "Object", 12, "o:Arg12(1, 2.5, 'x', true, 1, 2.5, 'x', true, 1, 2.5, 'x', true)");
+    return 0;
+}
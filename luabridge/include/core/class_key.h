@@ -30,6 +30,12 @@
 #ifndef __CLASS_KEY_H__
 #define __CLASS_KEY_H__
 
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <string>
+
 namespace luabridge
 {
 
@@ -124,6 +130,190 @@ inline const void *GetParentKey()
 #endif
 }
 
+/**
+ * The key of the registry table holding the metatables that use flattened dispatch.
+ */
+inline const void *GetFlatClassesKey()
+{
+#ifdef _NDEBUG
+    static char value;
+    return &value;
+#else
+    return reinterpret_cast <void *> (0xf1a);
+#endif
+}
+
+/**
+ * The key of the identity cache table (pointer -> userdata) in a class metatable.
+ */
+inline const void *GetIdentityCacheKey()
+{
+#ifdef _NDEBUG
+    static char value;
+    return &value;
+#else
+    return reinterpret_cast <void *> (0x1dc);
+#endif
+}
+
+/** Compact runtime identity of a registered class.
+
+    Every userdata created by LuaBridge records the ClassTypeInfo of its class,
+    so the common type checks are done with pointer compares instead of walking
+    the metatable chain on the Lua stack.
+    ancestors holds the class hierarchy from the root class down to the class
+    itself, so "is derived from" is a single indexed compare. The ClassTypeInfo
+    is shared by every lua_State, the hierarchy is set once by the first
+    DeriveClass and never changes after, the type checks read it without a lock.
+*/
+class ClassTypeInfo
+{
+public:
+    /**
+      Snapshot of the object counters of a class.
+      bytes is the size of the live userdata, for objects held by pointer or
+      container it does not include the C++ object itself.
+    */
+    struct Stats
+    {
+        std::string name;
+        size_t live;
+        size_t created;
+        size_t bytes;
+    };
+
+    ClassTypeInfo()
+        : m_parent(0), m_ancestors(&m_root), m_tracked(false), m_live(0), m_created(0), m_bytes(0)
+    {
+        m_root.push_back(this);
+    }
+
+    /** Record the parent class, set when the class is registered with DeriveClass.
+        Only the first call sets it, registering the class again in another
+        lua_State must name the same parent.
+    */
+    void SetParent(ClassTypeInfo const *parent)
+    {
+        std::lock_guard<std::mutex> lock(ParentMutex());
+        if (m_parent != 0) {
+            if (m_parent != parent) {
+                throw std::logic_error("The class is already derived from another class");
+            }
+            return;
+        }
+        m_derived = *parent->m_ancestors.load(std::memory_order_acquire);
+        m_derived.push_back(this);
+        m_parent = parent;
+        m_ancestors.store(&m_derived, std::memory_order_release);
+    }
+
+    /** Returns true if this class is base or is derived from it.
+    */
+    bool IsA(ClassTypeInfo const *base) const
+    {
+        std::vector<ClassTypeInfo const *> const &ancestors = *m_ancestors.load(std::memory_order_acquire);
+        size_t depth = base->m_ancestors.load(std::memory_order_acquire)->size() - 1;
+        return depth < ancestors.size() && ancestors[depth] == base;
+    }
+
+    /** Start counting the objects of the class, see Class<T>::EnableStats.
+    */
+    void EnableStats(std::string const &name)
+    {
+        std::lock_guard<std::mutex> lock(TrackedMutex());
+        if (!m_tracked.load(std::memory_order_relaxed)) {
+            TrackedList().push_back(this);
+            m_tracked.store(true, std::memory_order_relaxed);
+        }
+        m_name = name;
+    }
+
+    bool IsTracked() const
+    {
+        return m_tracked.load(std::memory_order_relaxed);
+    }
+
+    /** The counters are shared by every lua_State on every thread, relaxed
+        atomics are enough since they are only read as statistics.
+    */
+    void OnCreate(size_t bytes) const
+    {
+        m_live.fetch_add(1, std::memory_order_relaxed);
+        m_created.fetch_add(1, std::memory_order_relaxed);
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void OnDestroy(size_t bytes) const
+    {
+        m_live.fetch_sub(1, std::memory_order_relaxed);
+        m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    Stats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(TrackedMutex());
+        return GetStatsLocked();
+    }
+
+    /** Counters of every class with stats enabled.
+        The counters are process wide, summed over all lua_States.
+    */
+    static std::vector<Stats> Snapshot()
+    {
+        std::lock_guard<std::mutex> lock(TrackedMutex());
+        std::vector<Stats> result;
+        std::vector<ClassTypeInfo *> const &list = TrackedList();
+        for (size_t i = 0; i < list.size(); ++i) {
+            result.push_back(list[i]->GetStatsLocked());
+        }
+        return result;
+    }
+
+private:
+    Stats GetStatsLocked() const
+    {
+        Stats stats = {m_name,
+                       m_live.load(std::memory_order_relaxed),
+                       m_created.load(std::memory_order_relaxed),
+                       m_bytes.load(std::memory_order_relaxed)};
+        return stats;
+    }
+
+    /** Guards the tracked list and the class names.
+    */
+    static std::mutex &TrackedMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /** Guards the first SetParent.
+    */
+    static std::mutex &ParentMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<ClassTypeInfo *> &TrackedList()
+    {
+        static std::vector<ClassTypeInfo *> list;
+        return list;
+    }
+
+private:
+    ClassTypeInfo const *m_parent;
+    // m_ancestors points to m_root until SetParent fills m_derived, neither changes once published
+    std::vector<ClassTypeInfo const *> m_root;
+    std::vector<ClassTypeInfo const *> m_derived;
+    std::atomic<std::vector<ClassTypeInfo const *> const *> m_ancestors;
+    std::atomic<bool> m_tracked;
+    std::string m_name;
+    mutable std::atomic<size_t> m_live;
+    mutable std::atomic<size_t> m_created;
+    mutable std::atomic<size_t> m_bytes;
+};
+
 /** Unique Lua registry keys for a class.
 
     Each registered class inserts three keys into the registry, whose
@@ -168,6 +358,14 @@ public:
         static char value;
         return &value;
     }
+
+    /** Get the runtime identity of the class.
+    */
+    static ClassTypeInfo *GetTypeInfo()
+    {
+        static ClassTypeInfo info;
+        return &info;
+    }
 };
 } // namespace luabridge
 
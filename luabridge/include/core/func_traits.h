@@ -45,8 +45,7 @@ namespace luabridge
     belongs to if it is a class member, the const-ness if it is a member
     function, and the type information for the return value and argument list.
 
-    Expansions are provided for functions with up to 8 parameters. This can be
-    manually extended, or expanded to an arbitrary amount using C++11 features.
+    Calls are expanded by Caller for any number of parameters.
 */
 template<class MemFn, class D = MemFn>
 struct FuncTraits
@@ -136,7 +135,7 @@ struct FuncTraits<R (T::*)(ParamList...) const>
 
     static R call(lua_State*L,const ClassType *obj,const DeclType &fp,int startParam)
     {
-        return doCall<R,T,DeclType,ParamList...>(L,obj, fp,startParam);
+        return doCall<R,const T,DeclType,ParamList...>(L,obj, fp,startParam);
     }
 };
 
@@ -164,6 +163,20 @@ struct FuncTraits<std::function<R(ParamList...)>>
     }
 };
 
+/**
+ * 类数据成员指针U C::*
+ * @tparam MemPtr
+ */
+template<class MemPtr>
+struct DataMemberTraits;
+
+template<class C, class U>
+struct DataMemberTraits<U C::*>
+{
+    using ClassType = C;
+    using DataType = U;
+};
+
 template<class ReturnType,int startParam>
 struct Invoke
 {
@@ -181,7 +194,7 @@ struct Invoke
         }
         try {
             Stack<ReturnType>::push(L, FuncTraits<Fn>::call(L,fn,startParam));
-            return 1;
+            return StackCount<ReturnType>::value;
         }
         catch (const std::exception &e) {
             return LUA_ASSERT(L, false, e.what());
@@ -203,7 +216,7 @@ struct Invoke
         }
         try {
             Stack<ReturnType>::push(L, FuncTraits<MemFn>::call(L,object, fn,startParam));
-            return 1;
+            return StackCount<ReturnType>::value;
         }
         catch (const std::exception &e) {
             return LUA_ASSERT(L, false, e.what());
@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef __LUA_ALLOCATOR_H__
+#define __LUA_ALLOCATOR_H__
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "lua_library.h"
+
+namespace luabridge
+{
+
+/**
+ * 按大小分级的内存池lua_Alloc,用于替换luaL_newstate默认的realloc/free
+ *
+ * Blocks up to MAX_POOLED_SIZE bytes are served from per size class free
+ * lists carved out of CHUNK_SIZE chunks, this covers the small tables,
+ * strings, closures and userdata that make up most of Lua's allocations.
+ * Larger blocks go to malloc. Chunks are only returned to the system when
+ * the allocator is destroyed.
+ *
+ * A shrink never fails, as Lua requires: if the smaller block can't be
+ * allocated the old one is kept and serves the new size class.
+ *
+ * One allocator serves one lua_State and is not thread safe. It must outlive
+ * the lua_State, i.e. be destroyed after lua_close.
+ *
+ * Sample:  LuaPoolAllocator pool;
+ *          LuaBridge lua(pool);
+ *          printf("%zu live, %zu peak\n", pool.LiveBytes(), pool.PeakBytes());
+ */
+class LuaPoolAllocator
+{
+public:
+    enum
+    {
+        GRANULARITY = 16,
+        MAX_POOLED_SIZE = 256,
+        SIZE_CLASS_COUNT = MAX_POOLED_SIZE / GRANULARITY,
+        CHUNK_SIZE = 16 * 1024
+    };
+
+    /**
+     * Counters of one size class.
+     */
+    struct SizeClassStats
+    {
+        size_t blockSize;
+        size_t liveBlocks;
+        size_t peakBlocks;
+        size_t allocCount;
+        size_t freeCount;
+        size_t chunkCount;
+    };
+
+private:
+    LuaPoolAllocator(const LuaPoolAllocator &);
+    LuaPoolAllocator &operator=(const LuaPoolAllocator &);
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+public:
+    LuaPoolAllocator()
+        : m_liveBytes(0), m_peakBytes(0), m_largeLiveBytes(0), m_largeAllocCount(0), m_largeFreeCount(0)
+    {
+        for (int i = 0; i < SIZE_CLASS_COUNT; ++i) {
+            m_freeList[i] = NULL;
+            memset(&m_stats[i], 0, sizeof(SizeClassStats));
+            m_stats[i].blockSize = (i + 1) * GRANULARITY;
+        }
+    }
+
+    ~LuaPoolAllocator()
+    {
+        for (size_t i = 0; i < m_chunks.size(); ++i) {
+            free(m_chunks[i]);
+        }
+        for (size_t i = 0; i < m_adopted.size(); ++i) {
+            free(m_adopted[i]);
+        }
+    }
+
+    /**
+     * The lua_Alloc function, ud is the LuaPoolAllocator.
+     */
+    static void *Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+    {
+        LuaPoolAllocator *pool = static_cast<LuaPoolAllocator *>(ud);
+        // For a new block osize is the type of the object, not a size
+        if (ptr == NULL) {
+            osize = 0;
+        }
+        if (nsize == 0) {
+            pool->Free(ptr, osize);
+            return NULL;
+        }
+        return pool->Reallocate(ptr, osize, nsize);
+    }
+
+    /**
+     * Bytes requested by Lua and not freed yet.
+     */
+    size_t LiveBytes() const
+    {
+        return m_liveBytes;
+    }
+
+    size_t PeakBytes() const
+    {
+        return m_peakBytes;
+    }
+
+    void ResetPeak()
+    {
+        m_peakBytes = m_liveBytes;
+    }
+
+    /**
+     * Live bytes of blocks too large for the pool.
+     */
+    size_t LargeLiveBytes() const
+    {
+        return m_largeLiveBytes;
+    }
+
+    size_t LargeAllocCount() const
+    {
+        return m_largeAllocCount;
+    }
+
+    size_t LargeFreeCount() const
+    {
+        return m_largeFreeCount;
+    }
+
+    /**
+     * Memory reserved from the system for the pool.
+     */
+    size_t ReservedBytes() const
+    {
+        return m_chunks.size() * CHUNK_SIZE;
+    }
+
+    const SizeClassStats &GetSizeClassStats(int sizeClass) const
+    {
+        return m_stats[sizeClass];
+    }
+
+private:
+    static int SizeClass(size_t size)
+    {
+        return static_cast<int>((size + GRANULARITY - 1) / GRANULARITY) - 1;
+    }
+
+    void *Allocate(size_t size)
+    {
+        if (size > MAX_POOLED_SIZE) {
+            void *p = malloc(size);
+            if (p != NULL) {
+                m_largeLiveBytes += size;
+                ++m_largeAllocCount;
+                AddLive(size);
+            }
+            return p;
+        }
+        int sizeClass = SizeClass(size);
+        if (m_freeList[sizeClass] == NULL && !Refill(sizeClass)) {
+            return NULL;
+        }
+        FreeBlock *block = m_freeList[sizeClass];
+        m_freeList[sizeClass] = block->next;
+        SizeClassStats &stats = m_stats[sizeClass];
+        ++stats.allocCount;
+        if (++stats.liveBlocks > stats.peakBlocks) {
+            stats.peakBlocks = stats.liveBlocks;
+        }
+        AddLive(size);
+        return block;
+    }
+
+    void Free(void *ptr, size_t size)
+    {
+        if (ptr == NULL) {
+            return;
+        }
+        m_liveBytes -= size;
+        if (size > MAX_POOLED_SIZE) {
+            m_largeLiveBytes -= size;
+            ++m_largeFreeCount;
+            free(ptr);
+            return;
+        }
+        int sizeClass = SizeClass(size);
+        FreeBlock *block = static_cast<FreeBlock *>(ptr);
+        block->next = m_freeList[sizeClass];
+        m_freeList[sizeClass] = block;
+        --m_stats[sizeClass].liveBlocks;
+        ++m_stats[sizeClass].freeCount;
+    }
+
+    void *Reallocate(void *ptr, size_t osize, size_t nsize)
+    {
+        if (ptr != NULL) {
+            // Same size class, the block already fits
+            if (osize <= MAX_POOLED_SIZE && nsize <= MAX_POOLED_SIZE && SizeClass(osize) == SizeClass(nsize)) {
+                m_liveBytes -= osize;
+                AddLive(nsize);
+                return ptr;
+            }
+            if (osize > MAX_POOLED_SIZE && nsize > MAX_POOLED_SIZE) {
+                void *p = realloc(ptr, nsize);
+                if (p == NULL && nsize <= osize) {
+                    p = ptr;
+                }
+                if (p != NULL) {
+                    m_liveBytes -= osize;
+                    m_largeLiveBytes -= osize;
+                    m_largeLiveBytes += nsize;
+                    AddLive(nsize);
+                }
+                return p;
+            }
+        }
+        void *p = Allocate(nsize);
+        if (p == NULL && ptr != NULL && nsize <= osize) {
+            KeepForShrink(ptr, osize, nsize);
+            return ptr;
+        }
+        if (p != NULL && ptr != NULL) {
+            memcpy(p, ptr, osize < nsize ? osize : nsize);
+            Free(ptr, osize);
+        }
+        return p;
+    }
+
+    /**
+     * A shrink into a smaller size class failed, ptr stays in place and from
+     * now on is accounted and freed as a block of nsize bytes. It is at least
+     * as large as the blocks of that class, so it can go to its free list.
+     */
+    void KeepForShrink(void *ptr, size_t osize, size_t nsize)
+    {
+        m_liveBytes -= osize;
+        AddLive(nsize);
+        if (osize > MAX_POOLED_SIZE) {
+            // A malloc block joins the pool, free it with the chunks
+            m_largeLiveBytes -= osize;
+            ++m_largeFreeCount;
+            try {
+                m_adopted.push_back(ptr);
+            }
+            catch (...) {
+            }
+        }
+        else {
+            --m_stats[SizeClass(osize)].liveBlocks;
+        }
+        SizeClassStats &stats = m_stats[SizeClass(nsize)];
+        ++stats.allocCount;
+        if (++stats.liveBlocks > stats.peakBlocks) {
+            stats.peakBlocks = stats.liveBlocks;
+        }
+    }
+
+    /**
+     * Carve a new chunk into blocks of the size class.
+     */
+    bool Refill(int sizeClass)
+    {
+        char *chunk = static_cast<char *>(malloc(CHUNK_SIZE));
+        if (chunk == NULL) {
+            return false;
+        }
+        m_chunks.push_back(chunk);
+        ++m_stats[sizeClass].chunkCount;
+        size_t blockSize = m_stats[sizeClass].blockSize;
+        size_t count = CHUNK_SIZE / blockSize;
+        FreeBlock *head = m_freeList[sizeClass];
+        for (size_t i = count; i > 0; --i) {
+            FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * blockSize);
+            block->next = head;
+            head = block;
+        }
+        m_freeList[sizeClass] = head;
+        return true;
+    }
+
+    void AddLive(size_t size)
+    {
+        m_liveBytes += size;
+        if (m_liveBytes > m_peakBytes) {
+            m_peakBytes = m_liveBytes;
+        }
+    }
+
+private:
+    FreeBlock *m_freeList[SIZE_CLASS_COUNT];
+    SizeClassStats m_stats[SIZE_CLASS_COUNT];
+    std::vector<void *> m_chunks;
+    std::vector<void *> m_adopted; // large blocks kept by a failed shrink
+    size_t m_liveBytes;
+    size_t m_peakBytes;
+    size_t m_largeLiveBytes;
+    size_t m_largeAllocCount;
+    size_t m_largeFreeCount;
+};
+
+} // namespace luabridge
+
+#endif
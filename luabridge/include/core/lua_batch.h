@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef __LUA_BATCH_H__
+#define __LUA_BATCH_H__
+
+#include <iterator>
+#include <type_traits>
+#include "lua_library.h"
+#include "lua_helpers.h"
+#include "lua_stack.h"
+
+namespace luabridge
+{
+
+/**
+ * 批量调用时把一个元素压栈,类对象按引用(指针)传入lua,不拷贝
+ */
+struct BatchElement
+{
+    template<class V>
+    static void push(lua_State *L, V &v)
+    {
+        Stack<V &>::push(L, v);
+    }
+
+    template<class V>
+    static void push(lua_State *L, V *v)
+    {
+        Stack<V *>::push(L, v);
+    }
+};
+
+/**
+ * CallForEach的实现,在一次lua_pcall中对区间的每个元素调用lua函数
+ * @tparam Iter
+ */
+template<class Iter>
+struct ForEachCall
+{
+    const char *func;
+    Iter begin;
+    Iter end;
+
+    /**
+     * Runs under lua_pcall, the function is looked up once and called with
+     * lua_call for each element, so the setjmp cost is paid once per batch.
+     */
+    static int Run(lua_State *L)
+    {
+        ForEachCall<Iter> *call = static_cast<ForEachCall<Iter> *>(lua_touserdata(L, 1));
+        lua_getglobal(L, call->func);        // Stack: ctx, fn
+        for (Iter it = call->begin; it != call->end; ++it) {
+            lua_pushvalue(L, -1);            // Stack: ctx, fn, fn
+            BatchElement::push(L, *it);      // Stack: ctx, fn, fn, element
+            lua_call(L, 1, 0);               // Stack: ctx, fn
+        }
+        return 0;
+    }
+};
+
+/**
+ * 把一个c++区间作为类数组的userdata交给lua,lua中用r[i], #r遍历,元素不拷贝
+ *
+ * The view is only valid during the call, it is emptied afterwards so a script
+ * that keeps it reads nil instead of dangling memory.
+ * @tparam Iter random access iterator
+ */
+template<class Iter>
+class RangeView
+{
+    static_assert(std::is_base_of<std::random_access_iterator_tag,
+                                  typename std::iterator_traits<Iter>::iterator_category>::value,
+                  "RangeView needs a random access iterator");
+
+public:
+    RangeView(Iter begin, Iter end)
+        : m_begin(begin), m_size(static_cast<lua_Integer>(end - begin))
+    {
+    }
+
+    /**
+     * Push a new view with its metatable.
+     * @return the view, call Invalidate () on it once the call returns
+     */
+    static RangeView<Iter> *push(lua_State *L, Iter begin, Iter end)
+    {
+        RangeView<Iter> *view = new(lua_newuserdata(L, sizeof(RangeView<Iter>))) RangeView<Iter>(begin, end);
+        lua_rawgetp(L, LUA_REGISTRYINDEX, GetMetatableKey());
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 1);
+            lua_createtable(L, 0, 3);
+            lua_pushcfunction(L, &RangeView<Iter>::Index);
+            lua_setfield(L, -2, "__index");
+            lua_pushcfunction(L, &RangeView<Iter>::Len);
+            lua_setfield(L, -2, "__len");
+            lua_pushcfunction(L, &RangeView<Iter>::Gc);
+            lua_setfield(L, -2, "__gc");
+            lua_pushvalue(L, -1);
+            lua_rawsetp(L, LUA_REGISTRYINDEX, GetMetatableKey());
+        }
+        lua_setmetatable(L, -2);
+        return view;
+    }
+
+    void Invalidate()
+    {
+        m_size = 0;
+    }
+
+private:
+    static void const *GetMetatableKey()
+    {
+        static char value;
+        return &value;
+    }
+
+    static int Index(lua_State *L)
+    {
+        RangeView<Iter> *view = static_cast<RangeView<Iter> *>(lua_touserdata(L, 1));
+        int isnum = 0;
+        lua_Integer i = lua_tointegerx(L, 2, &isnum);
+        if (!isnum || i < 1 || i > view->m_size) {
+            lua_pushnil(L);
+            return 1;
+        }
+        BatchElement::push(L, *(view->m_begin + (i - 1)));
+        return 1;
+    }
+
+    static int Len(lua_State *L)
+    {
+        RangeView<Iter> *view = static_cast<RangeView<Iter> *>(lua_touserdata(L, 1));
+        lua_pushinteger(L, view->m_size);
+        return 1;
+    }
+
+    static int Gc(lua_State *L)
+    {
+        RangeView<Iter> *view = static_cast<RangeView<Iter> *>(lua_touserdata(L, 1));
+        view->~RangeView<Iter>();
+        return 0;
+    }
+
+private:
+    Iter m_begin;
+    lua_Integer m_size;
+};
+
+} // namespace luabridge
+
+#endif
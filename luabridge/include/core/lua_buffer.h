@@ -0,0 +1,286 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef __LUA_BUFFER_H__
+#define __LUA_BUFFER_H__
+
+#include <cstring>
+#include <stdexcept>
+#include "lua_helpers.h"
+#include "lua_space.h"
+#include "lua_class.h"
+
+namespace luabridge
+{
+
+/**
+ * 二进制缓冲区,引用c++持有的一段内存,在lua中按偏移读写整数,切片,不经过lua string拷贝
+ *
+ * The buffer does not own its bytes, the C++ owner must keep the memory alive
+ * while scripts can reach the buffer or any slice of it. Integers are read and
+ * written in host byte order. Out of range accesses throw std::out_of_range,
+ * which bound calls turn into a lua error.
+ *
+ * Register the class once with BinaryBuffer::Register (ns), then pass buffers
+ * to lua by pointer or reference (no copy at all) or by value (only the
+ * pointer and length are copied).
+ */
+class BinaryBuffer
+{
+public:
+    BinaryBuffer()
+        : m_pData(NULL), m_iSize(0), m_bReadOnly(true)
+    {
+    }
+
+    BinaryBuffer(void *data, size_t size)
+        : m_pData(static_cast<char *>(data)), m_iSize(size), m_bReadOnly(false)
+    {
+    }
+
+    /**
+     * Read only buffer, Write* throws.
+     */
+    BinaryBuffer(const void *data, size_t size)
+        : m_pData(static_cast<char *>(const_cast<void *>(data))), m_iSize(size), m_bReadOnly(true)
+    {
+    }
+
+    char *Data()
+    {
+        return m_pData;
+    }
+
+    const char *Data() const
+    {
+        return m_pData;
+    }
+
+    size_t Size() const
+    {
+        return m_iSize;
+    }
+
+    bool IsReadOnly() const
+    {
+        return m_bReadOnly;
+    }
+
+    /**
+     * Sub range [offset, offset + len) sharing the same memory.
+     */
+    BinaryBuffer Slice(size_t offset, size_t len) const
+    {
+        CheckRange(offset, len);
+        BinaryBuffer slice(*this);
+        slice.m_pData += offset;
+        slice.m_iSize = len;
+        return slice;
+    }
+
+    /**
+     * Copy of the bytes as a lua string.
+     */
+    StringView ToString() const
+    {
+        return StringView(m_pData != NULL ? m_pData : "", m_iSize);
+    }
+
+    int ReadInt8(size_t offset) const
+    {
+        return Load<signed char>(offset);
+    }
+
+    unsigned int ReadUInt8(size_t offset) const
+    {
+        return Load<unsigned char>(offset);
+    }
+
+    int ReadInt16(size_t offset) const
+    {
+        return Load<short>(offset);
+    }
+
+    unsigned int ReadUInt16(size_t offset) const
+    {
+        return Load<unsigned short>(offset);
+    }
+
+    int ReadInt32(size_t offset) const
+    {
+        return Load<int>(offset);
+    }
+
+    unsigned int ReadUInt32(size_t offset) const
+    {
+        return Load<unsigned int>(offset);
+    }
+
+    long long ReadInt64(size_t offset) const
+    {
+        return Load<long long>(offset);
+    }
+
+    float ReadFloat(size_t offset) const
+    {
+        return Load<float>(offset);
+    }
+
+    double ReadDouble(size_t offset) const
+    {
+        return Load<double>(offset);
+    }
+
+    void WriteInt8(size_t offset, int value)
+    {
+        Store<signed char>(offset, static_cast<signed char>(value));
+    }
+
+    void WriteUInt8(size_t offset, unsigned int value)
+    {
+        Store<unsigned char>(offset, static_cast<unsigned char>(value));
+    }
+
+    void WriteInt16(size_t offset, int value)
+    {
+        Store<short>(offset, static_cast<short>(value));
+    }
+
+    void WriteUInt16(size_t offset, unsigned int value)
+    {
+        Store<unsigned short>(offset, static_cast<unsigned short>(value));
+    }
+
+    void WriteInt32(size_t offset, int value)
+    {
+        Store<int>(offset, value);
+    }
+
+    void WriteUInt32(size_t offset, unsigned int value)
+    {
+        Store<unsigned int>(offset, value);
+    }
+
+    void WriteInt64(size_t offset, long long value)
+    {
+        Store<long long>(offset, value);
+    }
+
+    void WriteFloat(size_t offset, float value)
+    {
+        Store<float>(offset, value);
+    }
+
+    void WriteDouble(size_t offset, double value)
+    {
+        Store<double>(offset, value);
+    }
+
+    /**
+     * Copy a lua string into the buffer at offset.
+     */
+    void WriteString(size_t offset, StringView str)
+    {
+        CheckWritable();
+        CheckRange(offset, str.size());
+        memcpy(m_pData + offset, str.data(), str.size());
+    }
+
+    /**
+     * Register BinaryBuffer in the namespace.
+     */
+    static void Register(Namespace &ns)
+    {
+        ns.BeginClass<BinaryBuffer>("BinaryBuffer", false)
+            .AddFunction("Size", &BinaryBuffer::Size)
+            .AddFunction("IsReadOnly", &BinaryBuffer::IsReadOnly)
+            .AddFunction("Slice", &BinaryBuffer::Slice)
+            .AddFunction("ToString", &BinaryBuffer::ToString)
+            .AddFunction("ReadInt8", &BinaryBuffer::ReadInt8)
+            .AddFunction("ReadUInt8", &BinaryBuffer::ReadUInt8)
+            .AddFunction("ReadInt16", &BinaryBuffer::ReadInt16)
+            .AddFunction("ReadUInt16", &BinaryBuffer::ReadUInt16)
+            .AddFunction("ReadInt32", &BinaryBuffer::ReadInt32)
+            .AddFunction("ReadUInt32", &BinaryBuffer::ReadUInt32)
+            .AddFunction("ReadInt64", &BinaryBuffer::ReadInt64)
+            .AddFunction("ReadFloat", &BinaryBuffer::ReadFloat)
+            .AddFunction("ReadDouble", &BinaryBuffer::ReadDouble)
+            .AddFunction("WriteInt8", &BinaryBuffer::WriteInt8)
+            .AddFunction("WriteUInt8", &BinaryBuffer::WriteUInt8)
+            .AddFunction("WriteInt16", &BinaryBuffer::WriteInt16)
+            .AddFunction("WriteUInt16", &BinaryBuffer::WriteUInt16)
+            .AddFunction("WriteInt32", &BinaryBuffer::WriteInt32)
+            .AddFunction("WriteUInt32", &BinaryBuffer::WriteUInt32)
+            .AddFunction("WriteInt64", &BinaryBuffer::WriteInt64)
+            .AddFunction("WriteFloat", &BinaryBuffer::WriteFloat)
+            .AddFunction("WriteDouble", &BinaryBuffer::WriteDouble)
+            .AddFunction("WriteString", &BinaryBuffer::WriteString)
+            .EndClass();
+    }
+
+private:
+    void CheckRange(size_t offset, size_t len) const
+    {
+        if (offset > m_iSize || len > m_iSize - offset) {
+            throw std::out_of_range("BinaryBuffer access out of range");
+        }
+    }
+
+    void CheckWritable() const
+    {
+        if (m_bReadOnly) {
+            throw std::logic_error("BinaryBuffer is read only");
+        }
+    }
+
+    template<class V>
+    V Load(size_t offset) const
+    {
+        CheckRange(offset, sizeof(V));
+        V value;
+        memcpy(&value, m_pData + offset, sizeof(V));
+        return value;
+    }
+
+    template<class V>
+    void Store(size_t offset, V value)
+    {
+        CheckWritable();
+        CheckRange(offset, sizeof(V));
+        memcpy(m_pData + offset, &value, sizeof(V));
+    }
+
+private:
+    char *m_pData;
+    size_t m_iSize;
+    bool m_bReadOnly;
+};
+
+} // namespace luabridge
+
+#endif
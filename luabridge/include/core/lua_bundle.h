@@ -0,0 +1,448 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef __LUA_BUNDLE_H__
+#define __LUA_BUNDLE_H__
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lua_library.h"
+#include "lua_helpers.h"
+
+namespace luabridge
+{
+
+/**
+ * 脚本包文件格式
+ *
+ * BundleHeader, then count BundleEntry sorted by name hash, then the module
+ * names and chunks. Offsets are from the start of the file. A chunk is Lua
+ * source or bytecode, lua_load tells them apart.
+ */
+struct BundleHeader
+{
+    char magic[4];
+    unsigned int count;
+};
+
+struct BundleEntry
+{
+    unsigned long long hash;
+    unsigned long long nameOffset;
+    unsigned long long dataOffset;
+    unsigned long long dataSize;
+    unsigned int nameSize;
+    unsigned int reserved;
+};
+
+/**
+ * 只读的脚本包,整个文件mmap一次,require通过名字哈希在索引中二分查找,直接从映射内存加载
+ *
+ * Install () puts a searcher right after the preload searcher, so a module
+ * in the bundle is found without touching the file system, other modules
+ * fall through to package.path as before. The bundle must stay open while
+ * any lua_State it is installed in is alive.
+ *
+ * Sample:  ScriptBundle bundle;
+ *          bundle.Open("scripts.bundle");
+ *          lua.AddScriptBundle(bundle);
+ *          lua.LoadFile("main.lua"); // require "ai.fsm" comes from the bundle
+ */
+class ScriptBundle
+{
+private:
+    ScriptBundle(const ScriptBundle &);
+    ScriptBundle &operator=(const ScriptBundle &);
+
+public:
+    ScriptBundle()
+        : m_pData(NULL), m_iSize(0), m_pEntries(NULL), m_iCount(0)
+    {
+    }
+
+    ~ScriptBundle()
+    {
+        Close();
+    }
+
+    /**
+     * Map the bundle file.
+     * @return false if the file can't be mapped or is not a valid bundle
+     */
+    bool Open(const char *path)
+    {
+        Close();
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        void *data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(BundleHeader))) {
+            data = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        m_pData = static_cast<const char *>(data);
+        m_iSize = static_cast<size_t>(st.st_size);
+        if (!Validate()) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close()
+    {
+        if (m_pData != NULL) {
+            munmap(const_cast<char *>(m_pData), m_iSize);
+        }
+        m_pData = NULL;
+        m_iSize = 0;
+        m_pEntries = NULL;
+        m_iCount = 0;
+    }
+
+    bool IsOpen() const
+    {
+        return m_pData != NULL;
+    }
+
+    size_t Count() const
+    {
+        return m_iCount;
+    }
+
+    /**
+     * Find the chunk of a module.
+     * @return false if the module is not in the bundle
+     */
+    bool Find(const char *name, const char *&data, size_t &size) const
+    {
+        size_t nameSize = strlen(name);
+        unsigned long long hash = LuaHelper::HashBytes(name, nameSize);
+        const BundleEntry *end = m_pEntries + m_iCount;
+        const BundleEntry *it = std::lower_bound(m_pEntries, end, hash, &ScriptBundle::HashLess);
+        for (; it != end && it->hash == hash; ++it) {
+            if (it->nameSize == nameSize && memcmp(m_pData + it->nameOffset, name, nameSize) == 0) {
+                data = m_pData + it->dataOffset;
+                size = static_cast<size_t>(it->dataSize);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Insert the bundle searcher into package.searchers after the preload searcher.
+     */
+    void Install(lua_State *L) const
+    {
+        PushSearchers(L); // Stack: searchers
+        int count = static_cast<int>(lua_rawlen(L, -1));
+        int pos = count > 0 ? 2 : 1;
+        for (int i = count; i >= pos; --i) {
+            lua_rawgeti(L, -1, i); // Stack: searchers, searchers[i]
+            lua_rawseti(L, -2, i + 1); // Stack: searchers
+        }
+        lua_pushlightuserdata(L, const_cast<ScriptBundle *>(this)); // Stack: searchers, bundle
+        lua_pushcclosure(L, &ScriptBundle::Searcher, 1); // Stack: searchers, searcher
+        lua_rawseti(L, -2, pos); // Stack: searchers
+        lua_pop(L, 1); // Stack: -
+    }
+
+    /**
+     * Load a module of the bundle like luaL_loadbuffer, chunkname is "@name".
+     */
+    int Load(lua_State *L, const char *name) const
+    {
+        const char *data = NULL;
+        size_t size = 0;
+        if (!Find(name, data, size)) {
+            lua_pushfstring(L, "module '%s' not in bundle", name);
+            return LUA_ERRFILE;
+        }
+        lua_pushfstring(L, "@%s", name); // Stack: chunkname
+        int ret = luaL_loadbufferx(L, data, size, lua_tostring(L, -1), NULL); // Stack: chunkname, chunk | error
+        lua_remove(L, -2);
+        return ret;
+    }
+
+private:
+    static bool HashLess(const BundleEntry &entry, unsigned long long hash)
+    {
+        return entry.hash < hash;
+    }
+
+    bool Validate()
+    {
+        const BundleHeader *header = reinterpret_cast<const BundleHeader *>(m_pData);
+        if (memcmp(header->magic, "LBS1", 4) != 0
+            || header->count > (m_iSize - sizeof(BundleHeader)) / sizeof(BundleEntry)) {
+            return false;
+        }
+        m_pEntries = reinterpret_cast<const BundleEntry *>(m_pData + sizeof(BundleHeader));
+        m_iCount = header->count;
+        for (size_t i = 0; i < m_iCount; ++i) {
+            const BundleEntry &entry = m_pEntries[i];
+            if (entry.nameOffset > m_iSize || entry.nameSize > m_iSize - entry.nameOffset
+                || entry.dataOffset > m_iSize || entry.dataSize > m_iSize - entry.dataOffset
+                || (i > 0 && m_pEntries[i - 1].hash > entry.hash)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * package.searchers, package is the upvalue of require when luaopen_package
+     * was called without setting the global.
+     */
+    static void PushSearchers(lua_State *L)
+    {
+        lua_getglobal(L, "package"); // Stack: package | nil
+        if (!lua_istable(L, -1)) {
+            lua_pop(L, 1);
+            lua_getglobal(L, "require"); // Stack: require
+            LUA_ASSERT_EX(L, lua_iscfunction(L, -1) && lua_getupvalue(L, -1, 1) != NULL,
+                          "ScriptBundle::Install package library is not open", false); // Stack: require, package
+            lua_remove(L, -2); // Stack: package
+        }
+        LuaHelper::RawGetField(L, -1, "searchers"); // Stack: package, searchers
+        lua_remove(L, -2); // Stack: searchers
+        LUA_ASSERT_EX(L, lua_istable(L, -1), "ScriptBundle::Install package.searchers", false);
+    }
+
+    /**
+     * package.searchers entry, returns the loader and the module name,
+     * or a message when the module is not in the bundle.
+     */
+    static int Searcher(lua_State *L)
+    {
+        const ScriptBundle *bundle = static_cast<const ScriptBundle *>(lua_touserdata(L, lua_upvalueindex(1)));
+        const char *name = luaL_checkstring(L, 1);
+        const char *data = NULL;
+        size_t size = 0;
+        if (!bundle->Find(name, data, size)) {
+            lua_pushfstring(L, "\n\tno module '%s' in bundle", name);
+            return 1;
+        }
+        lua_pushfstring(L, "@%s", name); // Stack: name, chunkname
+        if (luaL_loadbufferx(L, data, size, lua_tostring(L, -1), NULL) != LUA_OK) // Stack: name, chunkname, loader
+        {
+            return luaL_error(L, "error loading module '%s' from bundle:\n\t%s", name, lua_tostring(L, -1));
+        }
+        lua_pushvalue(L, 1); // Stack: name, chunkname, loader, name
+        return 2;
+    }
+
+private:
+    const char *m_pData;
+    size_t m_iSize;
+    const BundleEntry *m_pEntries;
+    size_t m_iCount;
+};
+
+/**
+ * 脚本包生成器,在构建时把脚本打包,可选编译成字节码
+ *
+ * Sample:  ScriptBundleWriter writer;
+ *          writer.AddFile("ai.fsm", "scripts/ai/fsm.lua", true);
+ *          writer.Write("scripts.bundle");
+ */
+class ScriptBundleWriter
+{
+private:
+    struct Module
+    {
+        std::string name;
+        std::string data;
+    };
+
+public:
+    /**
+     * Add a module from memory, data is Lua source or bytecode.
+     */
+    void Add(const std::string &name, const std::string &data)
+    {
+        Module module;
+        module.name = name;
+        module.data = data;
+        m_modules.push_back(module);
+    }
+
+    /**
+     * Add a module from a script file.
+     * @param compile store bytecode instead of source
+     * @return false if the file can't be read or, when compiling, has a syntax error
+     */
+    bool AddFile(const std::string &name, const char *path, bool compile = false)
+    {
+        FILE *fp = fopen(path, "rb");
+        if (fp == NULL) {
+            return false;
+        }
+        std::string data;
+        char buf[4096];
+        size_t n = 0;
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+            data.append(buf, n);
+        }
+        fclose(fp);
+        if (compile && !Compile(name, data)) {
+            return false;
+        }
+        Add(name, data);
+        return true;
+    }
+
+    /**
+     * Write the bundle, modules with the same name keep the last one added.
+     */
+    bool Write(const char *path) const
+    {
+        std::vector<const Module *> modules;
+        std::vector<BundleEntry> entries;
+        std::set<std::string> names;
+        for (size_t i = m_modules.size(); i > 0; --i) {
+            const Module &module = m_modules[i - 1];
+            if (names.insert(module.name).second) {
+                modules.push_back(&module);
+                BundleEntry entry;
+                memset(&entry, 0, sizeof(entry));
+                entry.hash = LuaHelper::HashBytes(module.name.data(), module.name.size());
+                entry.nameSize = static_cast<unsigned int>(module.name.size());
+                entry.dataSize = module.data.size();
+                entries.push_back(entry);
+            }
+        }
+
+        // Sort by hash, keeping each entry with its module
+        std::vector<size_t> order(entries.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), IndexLess(entries));
+
+        BundleHeader header;
+        memcpy(header.magic, "LBS1", 4);
+        header.count = static_cast<unsigned int>(entries.size());
+        unsigned long long offset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+        std::vector<BundleEntry> sorted;
+        for (size_t i = 0; i < order.size(); ++i) {
+            BundleEntry entry = entries[order[i]];
+            entry.nameOffset = offset;
+            offset += entry.nameSize;
+            entry.dataOffset = offset;
+            offset += entry.dataSize;
+            sorted.push_back(entry);
+        }
+
+        // Unique temporary name, concurrent writers or a leftover file must not clobber each other
+        std::string tmp = std::string(path) + ".XXXXXX";
+        int fd = mkstemp(&tmp[0]);
+        if (fd < 0) {
+            return false;
+        }
+        fchmod(fd, 0644);
+        FILE *fp = fdopen(fd, "wb");
+        if (fp == NULL) {
+            close(fd);
+            remove(tmp.c_str());
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+            && (sorted.empty() || fwrite(&sorted[0], sizeof(BundleEntry), sorted.size(), fp) == sorted.size());
+        for (size_t i = 0; i < order.size() && ok; ++i) {
+            const Module &module = *modules[order[i]];
+            ok = fwrite(module.name.data(), 1, module.name.size(), fp) == module.name.size()
+                && fwrite(module.data.data(), 1, module.data.size(), fp) == module.data.size();
+        }
+        ok = fclose(fp) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), path) != 0) {
+            remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct IndexLess
+    {
+        explicit IndexLess(const std::vector<BundleEntry> &entries)
+            : m_entries(entries)
+        {
+        }
+
+        bool operator()(size_t a, size_t b) const
+        {
+            return m_entries[a].hash < m_entries[b].hash;
+        }
+
+        const std::vector<BundleEntry> &m_entries;
+    };
+
+    /**
+     * Replace the source with bytecode, debug info is kept for error messages.
+     */
+    static bool Compile(const std::string &name, std::string &data)
+    {
+        lua_State *L = luaL_newstate();
+        if (L == NULL) {
+            return false;
+        }
+        std::string chunkname = "@" + name;
+        std::string bytecode;
+        bool ok = luaL_loadbufferx(L, data.data(), data.size(), chunkname.c_str(), "t") == LUA_OK
+            && lua_dump(L, &LuaHelper::StringWriter, &bytecode, 0) == 0;
+        lua_close(L);
+        if (ok) {
+            data.swap(bytecode);
+        }
+        return ok;
+    }
+
+private:
+    std::vector<Module> m_modules;
+};
+
+} // namespace luabridge
+
+#endif
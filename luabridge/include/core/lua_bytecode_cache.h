@@ -0,0 +1,450 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef __LUA_BYTECODE_CACHE_H__
+#define __LUA_BYTECODE_CACHE_H__
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lua_library.h"
+#include "lua_helpers.h"
+
+namespace luabridge
+{
+
+/**
+ * lua字节码缓存,脚本编译一次后用lua_dump保存,之后直接lua_load字节码,跳过词法和语法分析
+ *
+ * An entry is keyed by the source path and is valid while the source file
+ * has the same mtime, size and content hash (64 bit FNV-1a). Any change
+ * makes the entry stale and the file is compiled again. The source is still
+ * read and hashed on every load, that is cheap compared to parsing.
+ *
+ * Entries are kept in memory and, if a cache directory is given, also in
+ * one file per script so later processes start warm. The directory must
+ * exist. A cache file that can't be read or was written by another Lua
+ * build is ignored and rewritten, as is one whose bytecode doesn't match
+ * the checksum in its header (Lua doesn't verify bytecode it loads). Bytecode
+ * keeps debug info, so error messages still show the script path and line.
+ * Like luaL_loadfile, a UTF-8 BOM and a first line starting with # are
+ * skipped.
+ *
+ * The cache can be shared by several lua_States of the same thread.
+ * Precompile () compiles a list of scripts on worker threads ahead of the
+ * Load calls, each worker uses its own scratch lua_State.
+ *
+ * Sample:  BytecodeCache cache("./luac_cache");
+ *          lua.SetBytecodeCache(&cache);
+ *          lua.LoadFile("main.lua");
+ */
+class BytecodeCache
+{
+public:
+    /**
+     * Counters since construction.
+     */
+    struct Stats
+    {
+        size_t hits;
+        size_t misses;
+        size_t stale;
+    };
+
+private:
+    BytecodeCache(const BytecodeCache &);
+    BytecodeCache &operator=(const BytecodeCache &);
+
+    struct Entry
+    {
+        long long mtime;
+        unsigned long long size;
+        unsigned long long hash;
+        std::string bytecode;
+    };
+
+    /**
+     * Cache file header, followed by the source path and the bytecode.
+     */
+    struct FileHeader
+    {
+        char magic[4];
+        unsigned int pathSize;
+        long long mtime;
+        unsigned long long size;
+        unsigned long long hash;
+        unsigned long long bytecodeSize;
+        unsigned long long bytecodeHash;
+    };
+
+public:
+    /**
+     * @param cacheDir directory for cache files, empty keeps the cache in memory only
+     */
+    explicit BytecodeCache(const std::string &cacheDir = std::string())
+        : m_cacheDir(cacheDir)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+        if (!m_cacheDir.empty() && m_cacheDir[m_cacheDir.size() - 1] != '/') {
+            m_cacheDir += '/';
+        }
+    }
+
+    /**
+     * Load the script like luaL_loadfile, from the cache when it's fresh.
+     * @return LUA_OK with the chunk on the stack, or an error code with the message on the stack
+     */
+    int Load(lua_State *L, const char *path)
+    {
+        Entry source;
+        std::string code;
+        if (!ReadSource(path, source, code)) {
+            lua_pushfstring(L, "cannot open %s", path);
+            return LUA_ERRFILE;
+        }
+
+        std::string chunkname = std::string("@") + path;
+        Entry *entry = Find(path, source);
+        if (entry != NULL) {
+            if (luaL_loadbufferx(L, entry->bytecode.data(), entry->bytecode.size(), chunkname.c_str(), "b") == LUA_OK) {
+                ++m_stats.hits;
+                return LUA_OK;
+            }
+            // Written by another Lua build
+            lua_pop(L, 1);
+            m_entries.erase(path);
+        }
+
+        ++m_stats.misses;
+        size_t skip = SkipPrefix(code);
+        int ret = luaL_loadbufferx(L, code.data() + skip, code.size() - skip, chunkname.c_str(), NULL);
+        if (ret != LUA_OK) {
+            return ret;
+        }
+        if (lua_dump(L, &LuaHelper::StringWriter, &source.bytecode, 0) == 0) {
+            Store(path, source);
+        }
+        return LUA_OK;
+    }
+
+    /**
+     * Compile the scripts in parallel so the following Load calls are cache hits.
+     *
+     * Workers read and hash the sources, skip fresh entries, and compile and
+     * write the cache files of the others. The entries are added once all
+     * workers are done. A script that fails to compile is skipped here and
+     * reports its error when it is loaded.
+     * @param threads number of worker threads, 0 uses std::thread::hardware_concurrency ()
+     */
+    void Precompile(const std::vector<std::string> &paths, unsigned int threads = 0)
+    {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        if (threads == 0) {
+            threads = 1;
+        }
+        if (threads > paths.size()) {
+            threads = static_cast<unsigned int>(paths.size());
+        }
+
+        std::vector<Job> jobs(paths.size());
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> workers;
+        for (unsigned int i = 1; i < threads; ++i) {
+            workers.push_back(std::thread(&BytecodeCache::PrecompileWorker, this, &paths, &jobs, &next));
+        }
+        PrecompileWorker(&paths, &jobs, &next);
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (jobs[i].state == JOB_COMPILED) {
+                ++m_stats.misses;
+            }
+            if (jobs[i].state == JOB_COMPILED || jobs[i].state == JOB_FROM_FILE) {
+                Entry &entry = m_entries[paths[i]];
+                entry.bytecode.swap(jobs[i].entry.bytecode);
+                entry.mtime = jobs[i].entry.mtime;
+                entry.size = jobs[i].entry.size;
+                entry.hash = jobs[i].entry.hash;
+            }
+        }
+    }
+
+    /**
+     * Drop all entries in memory, cache files are kept.
+     */
+    void Clear()
+    {
+        m_entries.clear();
+    }
+
+    const Stats &GetStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    enum
+    {
+        JOB_SKIPPED,
+        JOB_COMPILED,
+        JOB_FROM_FILE
+    };
+
+    struct Job
+    {
+        Job()
+            : state(JOB_SKIPPED)
+        {
+        }
+
+        Entry entry;
+        int state;
+    };
+
+    /**
+     * Runs on a worker thread, m_entries is only read until all workers are joined.
+     */
+    void PrecompileWorker(const std::vector<std::string> *paths, std::vector<Job> *jobs, std::atomic<size_t> *next) const
+    {
+        lua_State *L = NULL;
+        for (size_t i = (*next)++; i < paths->size(); i = (*next)++) {
+            const char *path = (*paths)[i].c_str();
+            Job &job = (*jobs)[i];
+            std::string code;
+            if (!ReadSource(path, job.entry, code)) {
+                continue;
+            }
+            std::unordered_map<std::string, Entry>::const_iterator it = m_entries.find((*paths)[i]);
+            if (it != m_entries.end() && IsFresh(it->second, job.entry)) {
+                continue;
+            }
+            Entry cached;
+            if (!m_cacheDir.empty() && ReadCacheFile(path, cached) && IsFresh(cached, job.entry)) {
+                job.entry.bytecode.swap(cached.bytecode);
+                job.state = JOB_FROM_FILE;
+                continue;
+            }
+
+            if (L == NULL) {
+                L = luaL_newstate();
+                if (L == NULL) {
+                    return;
+                }
+            }
+            std::string chunkname = std::string("@") + path;
+            size_t skip = SkipPrefix(code);
+            if (luaL_loadbufferx(L, code.data() + skip, code.size() - skip, chunkname.c_str(), NULL) == LUA_OK
+                && lua_dump(L, &LuaHelper::StringWriter, &job.entry.bytecode, 0) == 0) {
+                job.state = JOB_COMPILED;
+                if (!m_cacheDir.empty()) {
+                    WriteCacheFile(path, job.entry);
+                }
+            }
+            lua_settop(L, 0);
+        }
+        if (L != NULL) {
+            lua_close(L);
+        }
+    }
+
+    static bool ReadFile(FILE *fp, std::string &out, size_t size)
+    {
+        out.resize(size);
+        return size == 0 || fread(&out[0], 1, size, fp) == size;
+    }
+
+    static bool ReadSource(const char *path, Entry &source, std::string &code)
+    {
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            return false;
+        }
+        FILE *fp = fopen(path, "rb");
+        if (fp == NULL) {
+            return false;
+        }
+        bool ok = ReadFile(fp, code, static_cast<size_t>(st.st_size));
+        fclose(fp);
+        source.mtime = static_cast<long long>(st.st_mtime);
+        source.size = static_cast<unsigned long long>(st.st_size);
+        source.hash = LuaHelper::HashBytes(code.data(), code.size());
+        return ok;
+    }
+
+    /**
+     * Length of the UTF-8 BOM and the first line if it starts with #, skipped like
+     * skipcomment in lauxlib.c. The newline is kept so line numbers don't change.
+     */
+    static size_t SkipPrefix(const std::string &code)
+    {
+        size_t pos = 0;
+        if (code.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            pos = 3;
+        }
+        if (pos < code.size() && code[pos] == '#') {
+            size_t eol = code.find('\n', pos);
+            pos = eol == std::string::npos ? code.size() : eol;
+        }
+        return pos;
+    }
+
+    static bool IsFresh(const Entry &entry, const Entry &source)
+    {
+        return entry.mtime == source.mtime && entry.size == source.size && entry.hash == source.hash;
+    }
+
+    /**
+     * The fresh entry of path, from memory or the cache file, or NULL.
+     */
+    Entry *Find(const char *path, const Entry &source)
+    {
+        std::unordered_map<std::string, Entry>::iterator it = m_entries.find(path);
+        if (it != m_entries.end()) {
+            if (IsFresh(it->second, source)) {
+                return &it->second;
+            }
+            ++m_stats.stale;
+            m_entries.erase(it);
+            return NULL;
+        }
+
+        if (m_cacheDir.empty()) {
+            return NULL;
+        }
+        Entry entry;
+        if (!ReadCacheFile(path, entry)) {
+            return NULL;
+        }
+        if (!IsFresh(entry, source)) {
+            ++m_stats.stale;
+            return NULL;
+        }
+        return &(m_entries[path] = entry);
+    }
+
+    void Store(const char *path, Entry &source)
+    {
+        if (!m_cacheDir.empty()) {
+            WriteCacheFile(path, source);
+        }
+        m_entries[path].bytecode.swap(source.bytecode);
+        Entry &entry = m_entries[path];
+        entry.mtime = source.mtime;
+        entry.size = source.size;
+        entry.hash = source.hash;
+    }
+
+    std::string CacheFilePath(const char *path) const
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.luac", LuaHelper::HashBytes(path, strlen(path)));
+        return m_cacheDir + name;
+    }
+
+    bool ReadCacheFile(const char *path, Entry &entry) const
+    {
+        FILE *fp = fopen(CacheFilePath(path).c_str(), "rb");
+        if (fp == NULL) {
+            return false;
+        }
+        FileHeader header;
+        std::string cachedPath;
+        bool ok = fread(&header, sizeof(header), 1, fp) == 1
+            && memcmp(header.magic, "LBC2", 4) == 0
+            && ReadFile(fp, cachedPath, header.pathSize)
+            && cachedPath == path
+            && ReadFile(fp, entry.bytecode, static_cast<size_t>(header.bytecodeSize))
+            && LuaHelper::HashBytes(entry.bytecode.data(), entry.bytecode.size()) == header.bytecodeHash;
+        fclose(fp);
+        if (ok) {
+            entry.mtime = header.mtime;
+            entry.size = header.size;
+            entry.hash = header.hash;
+        }
+        return ok;
+    }
+
+    /**
+     * Write to a temporary file and rename it, so a reader never sees a partial file.
+     */
+    void WriteCacheFile(const char *path, const Entry &entry) const
+    {
+        FileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "LBC2", 4);
+        header.pathSize = static_cast<unsigned int>(strlen(path));
+        header.mtime = entry.mtime;
+        header.size = entry.size;
+        header.hash = entry.hash;
+        header.bytecodeSize = entry.bytecode.size();
+        header.bytecodeHash = LuaHelper::HashBytes(entry.bytecode.data(), entry.bytecode.size());
+
+        // Unique temporary name, other threads or processes may write the same entry
+        std::string file = CacheFilePath(path);
+        std::string tmp = file + ".XXXXXX";
+        int fd = mkstemp(&tmp[0]);
+        if (fd < 0) {
+            return;
+        }
+        fchmod(fd, 0644);
+        FILE *fp = fdopen(fd, "wb");
+        if (fp == NULL) {
+            close(fd);
+            remove(tmp.c_str());
+            return;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+            && fwrite(path, 1, header.pathSize, fp) == header.pathSize
+            && fwrite(entry.bytecode.data(), 1, entry.bytecode.size(), fp) == entry.bytecode.size();
+        ok = fclose(fp) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), file.c_str()) != 0) {
+            remove(tmp.c_str());
+        }
+    }
+
+private:
+    std::string m_cacheDir;
+    std::unordered_map<std::string, Entry> m_entries;
+    Stats m_stats;
+};
+
+} // namespace luabridge
+
+#endif
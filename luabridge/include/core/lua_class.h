@@ -32,6 +32,7 @@
 #include <functional>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <cassert>
 #include "lua_vm.h"
 #include "security.h"
@@ -41,6 +42,7 @@
 #include "lua_exception.h"
 #include "lua_helpers.h"
 #include "constructor.h"
+#include "lua_enum.h"
 
 namespace luabridge
 {
@@ -52,7 +54,7 @@ class ClassBase
 {
 public:
     explicit ClassBase(const char *name, LuaVm *puaVm, bool shared)
-        : className(name), m_pLuaVm(puaVm), m_bshared(shared)
+        : className(name), m_pLuaVm(puaVm), m_bshared(shared), m_bFlatDispatch(false)
     {
     }
 
@@ -237,10 +239,227 @@ protected:
                           + name).c_str(),
                       luaerror);
     }
+
+    //--------------------------------------------------------------------------
+    /**
+      Returns true if the metatable at index is base or derives from it.
+      The base index must be absolute.
+    */
+    static bool InheritsFrom(lua_State *L, int index, int base)
+    {
+        lua_pushvalue(L, index); // Stack: mt
+        for (;;) {
+            if (lua_rawequal(L, -1, base)) {
+                lua_pop(L, 1); // Stack: -
+                return true;
+            }
+            lua_rawgetp(L, -1, GetParentKey()); // Stack: mt, parent mt | nil
+            lua_remove(L, -2); // Stack: parent mt | nil
+            if (lua_isnil(L, -1)) {
+                lua_pop(L, 1); // Stack: -
+                return false;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Build the merged lookup table of the metatable at index and push it.
+
+      Functions and propget getters of the class and all of its parents are
+      copied in, the nearest definition wins just like in IndexMetaMethod.
+      Functions are stored as is, getters (closures or PropertyAccessor
+      userdata) are stored as {getter}.
+    */
+    static void BuildFlatTable(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        lua_newtable(L); // Stack: flat table (ft)
+        lua_pushvalue(L, index); // Stack: ft, mt
+
+        while (lua_istable(L, -1)) {
+            lua_pushnil(L); // Stack: ft, mt, nil
+            while (lua_next(L, -2)) // Stack: ft, mt, key, value
+            {
+                // Don't let the new cache reference the cache it replaces
+                if (lua_type(L, -2) == LUA_TSTRING && lua_iscfunction(L, -1)
+                    && lua_tocfunction(L, -1) != &CFunc::FlatIndexMetaMethod) {
+                    lua_pushvalue(L, -2); // Stack: ft, mt, key, value, key
+                    if (lua_rawget(L, -5) == LUA_TNIL) // Stack: ft, mt, key, value, ft[key]
+                    {
+                        lua_pushvalue(L, -3); // Stack: ft, mt, key, value, nil, key
+                        lua_pushvalue(L, -3); // Stack: ft, mt, key, value, nil, key, value
+                        lua_rawset(L, -7); // ft[key] = value. Stack: ft, mt, key, value, nil
+                    }
+                    lua_pop(L, 1); // Stack: ft, mt, key, value
+                }
+                lua_pop(L, 1); // Stack: ft, mt, key
+            }
+
+            lua_rawgetp(L, -1, GetPropgetKey()); // Stack: ft, mt, propget table (pg)
+            LUA_ASSERT_EX(L, lua_istable(L, -1), "BuildFlatTable lua_istable(L, -1)", false);
+            lua_pushnil(L); // Stack: ft, mt, pg, nil
+            while (lua_next(L, -2)) // Stack: ft, mt, pg, key, getter
+            {
+                if (lua_type(L, -2) == LUA_TSTRING) {
+                    lua_pushvalue(L, -2); // Stack: ft, mt, pg, key, getter, key
+                    if (lua_rawget(L, -6) == LUA_TNIL) // Stack: ft, mt, pg, key, getter, ft[key]
+                    {
+                        lua_pushvalue(L, -3); // Stack: ft, mt, pg, key, getter, nil, key
+                        lua_createtable(L, 1, 0); // Stack: ft, mt, pg, key, getter, nil, key, {}
+                        lua_pushvalue(L, -4); // Stack: ft, mt, pg, key, getter, nil, key, {}, getter
+                        lua_rawseti(L, -2, 1); // Stack: ft, mt, pg, key, getter, nil, key, {getter}
+                        lua_rawset(L, -8); // ft[key] = {getter}. Stack: ft, mt, pg, key, getter, nil
+                    }
+                    lua_pop(L, 1); // Stack: ft, mt, pg, key, getter
+                }
+                lua_pop(L, 1); // Stack: ft, mt, pg, key
+            }
+            lua_pop(L, 1); // Stack: ft, mt
+
+            lua_rawgetp(L, -1, GetParentKey()); // Stack: ft, mt, parent mt | nil
+            lua_remove(L, -2); // Stack: ft, parent mt | nil
+        }
+        lua_pop(L, 1); // Stack: ft
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Returns true if the metatable at index has no parent and no properties.
+    */
+    static bool IsMethodOnly(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        lua_rawgetp(L, index, GetParentKey()); // Stack: parent mt | nil
+        bool hasParent = !lua_isnil(L, -1);
+        lua_pop(L, 1); // Stack: -
+        if (hasParent) {
+            return false;
+        }
+
+        lua_rawgetp(L, index, GetPropgetKey()); // Stack: propget table (pg)
+        lua_pushnil(L); // Stack: pg, nil
+        bool hasProperty = lua_next(L, -2) != 0; // Stack: pg, key, getter | pg
+        lua_pop(L, hasProperty ? 3 : 1); // Stack: -
+        return !hasProperty;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Install the merged lookup table of the metatable at index as its __index.
+
+      A class with neither properties nor parents gets the table itself, so
+      methods are resolved by the Lua VM without entering C. Otherwise the
+      table is the upvalue of FlatIndexMetaMethod.
+    */
+    static void SetFlatIndex(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        BuildFlatTable(L, index); // Stack: flat table (ft)
+        if (!IsMethodOnly(L, index)) {
+            lua_pushcclosure(L, &CFunc::FlatIndexMetaMethod, 1); // Stack: function
+        }
+        LuaHelper::RawSetField(L, index, "__index"); // Stack: -
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Create the weak-valued identity cache of the metatable at index if it
+      does not exist yet.
+    */
+    static void CreateIdentityCache(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        lua_rawgetp(L, index, GetIdentityCacheKey()); // Stack: cache | nil
+        bool exists = lua_istable(L, -1);
+        lua_pop(L, 1); // Stack: -
+        if (exists) {
+            return;
+        }
+        lua_newtable(L); // Stack: cache
+        lua_createtable(L, 0, 1); // Stack: cache, cache mt
+        lua_pushliteral(L, "v");
+        lua_setfield(L, -2, "__mode"); // Stack: cache, cache mt
+        lua_setmetatable(L, -2); // Stack: cache
+        lua_rawsetp(L, index, GetIdentityCacheKey()); // Stack: -
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Keep the __index of the class metatables in sync with the class tables.
+
+      When the class is reopened for modification, its own metatables and
+      every flattened metatable deriving from it fall back to the plain
+      IndexMetaMethod. At EndClass () they are rebuilt: method-only classes
+      get their method table as __index, flattened classes get the merged
+      lookup table of their hierarchy.
+
+      The Lua stack should have the const table, class table and static table on top.
+    */
+    void UpdateIndexMetaMethods(bool rebuild)
+    {
+        lua_State *L = m_pLuaVm->LuaState();
+        // Stack: const table (co), class table (cl), static table (st)
+        int co = lua_absindex(L, -3);
+        int cl = lua_absindex(L, -2);
+        bool enable = rebuild && m_bFlatDispatch;
+
+        if (!rebuild) {
+            lua_pushcfunction(L, &CFunc::IndexMetaMethod); // Stack: co, cl, st, function
+            lua_pushvalue(L, -1); // Stack: co, cl, st, function, function
+            LuaHelper::RawSetField(L, co, "__index"); // Stack: co, cl, st, function
+            LuaHelper::RawSetField(L, cl, "__index"); // Stack: co, cl, st
+        }
+        else if (!enable) {
+            if (IsMethodOnly(L, co)) {
+                SetFlatIndex(L, co);
+            }
+            if (IsMethodOnly(L, cl)) {
+                SetFlatIndex(L, cl);
+            }
+        }
+
+        lua_rawgetp(L, LUA_REGISTRYINDEX, GetFlatClassesKey()); // Stack: co, cl, st, flat classes (fc) | nil
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 1); // Stack: co, cl, st
+            if (!enable) {
+                return;
+            }
+            lua_newtable(L); // Stack: co, cl, st, fc
+            lua_pushvalue(L, -1); // Stack: co, cl, st, fc, fc
+            lua_rawsetp(L, LUA_REGISTRYINDEX, GetFlatClassesKey()); // Stack: co, cl, st, fc
+        }
+
+        if (enable) {
+            lua_pushvalue(L, co); // Stack: co, cl, st, fc, co
+            lua_pushboolean(L, 1); // Stack: co, cl, st, fc, co, true
+            lua_rawset(L, -3); // fc [co] = true. Stack: co, cl, st, fc
+            lua_pushvalue(L, cl); // Stack: co, cl, st, fc, cl
+            lua_pushboolean(L, 1); // Stack: co, cl, st, fc, cl, true
+            lua_rawset(L, -3); // fc [cl] = true. Stack: co, cl, st, fc
+        }
+
+        lua_pushnil(L); // Stack: co, cl, st, fc, nil
+        while (lua_next(L, -2)) // Stack: co, cl, st, fc, mt, true
+        {
+            lua_pop(L, 1); // Stack: co, cl, st, fc, mt
+            if (InheritsFrom(L, -1, co) || InheritsFrom(L, -1, cl)) {
+                if (rebuild) {
+                    SetFlatIndex(L, -1); // Stack: co, cl, st, fc, mt
+                }
+                else {
+                    lua_pushcfunction(L, &CFunc::IndexMetaMethod); // Stack: co, cl, st, fc, mt, function
+                    LuaHelper::RawSetField(L, -2, "__index"); // Stack: co, cl, st, fc, mt
+                }
+            }
+        }
+        lua_pop(L, 1); // Stack: co, cl, st
+    }
 protected:
     std::string className;
     LuaVm *m_pLuaVm;
     bool m_bshared;
+    bool m_bFlatDispatch;
 };
 
 //============================================================================
@@ -271,9 +490,9 @@ public:
       co(const table) = {
           __metatable = co,
           typekey = const_name,
-          __index = &CFunc::IndexMetaMethod,
+          __index = &CFunc::IndexMetaMethod,(EndClass后,没有属性和父类的类为成员函数表),
           __newindex = &CFunc::NewindexStaticMetaMethod,
-          __gc = &CFunc::GCMetaMethod<T>,
+          __gc = &CFunc::GCMetaMethod<T>,(T的析构为空操作且非shared时不注册),
           propgetKey = {table}(通过addProperty注册普通成员变量的get方法会注册在这里),
           classKey = cl,
           func1_name = func1,(普通成员函数1 会被注册在这个表里),
@@ -283,9 +502,9 @@ public:
       cl(class table) = {
           __metatable = cl,
           typekey = name,
-          __index = &CFunc::IndexMetaMethod,
+          __index = &CFunc::IndexMetaMethod,(EndClass后,没有属性和父类的类为成员函数表),
           __newindex = &CFunc::NewindexStaticMetaMethod,
-          __gc = &CFunc::GCMetaMethod<T>,
+          __gc = &CFunc::GCMetaMethod<T>,(T的析构为空操作且非shared时不注册),
           propgetKey = {}(table)(通过addProperty注册普通成员变量的get方法也会注册在这里),
           propsetKey = {}(table)(通过addProperty注册普通成员变量的set方法也会注册在这里),,
           constKey = co,
@@ -331,19 +550,23 @@ public:
             //create类的const metadata表(co),and set co.__metatable = co
             CreateConstTable(name);
             //now 栈状态lua_gettop(L)== n + 2:ns=>co
-            //注册gc元方法
-            lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); // 栈状态lua_gettop(L)== n + 3:ns=>co=>gcfun
-            //co.__gc = gcfun 即co.__metatable.__gc = gcfun 栈状态lua_gettop(L)== n + 2:ns=>co
-            LuaHelper::RawSetField(L, -2, "__gc");
+            //注册gc元方法,析构为空操作的类不注册,对象不进入lua的finalizer链表
+            if (Userdata::NeedsGcMetaMethod<T>(shared)) {
+                lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); // 栈状态lua_gettop(L)== n + 3:ns=>co=>gcfun
+                //co.__gc = gcfun 即co.__metatable.__gc = gcfun 栈状态lua_gettop(L)== n + 2:ns=>co
+                LuaHelper::RawSetField(L, -2, "__gc");
+            }
             m_pLuaVm->AddStackSize(1);
 
             //create类的非const metadata表 and set cl.__metatable = cl
             CreateClassTable(name); //class table (cl) stack栈状态lua_gettop(L)== n + 3:ns=>co=>cl
             //now 栈状态lua_gettop(L) == n + 3:ns=>co=>cl
             //注册gc元方法
-            lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); //gcfun stack栈状态lua_gettop(L)== n + 4:ns=>co=>cl=>gcfun
-            //cl.__gc = gcfun 即 cl.__metatable.__gc = gcfun stack栈状态lua_gettop(L)== n + 3:ns=>co=>cl
-            LuaHelper::RawSetField(L, -2, "__gc");
+            if (Userdata::NeedsGcMetaMethod<T>(shared)) {
+                lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); //gcfun stack栈状态lua_gettop(L)== n + 4:ns=>co=>cl=>gcfun
+                //cl.__gc = gcfun 即 cl.__metatable.__gc = gcfun stack栈状态lua_gettop(L)== n + 3:ns=>co=>cl
+                LuaHelper::RawSetField(L, -2, "__gc");
+            }
             m_pLuaVm->AddStackSize(1);
 
             //create类的static metadata表 and set st.__metatable = st
@@ -426,6 +649,8 @@ public:
             lua_insert(L, -2); // Stack 栈状态ua_gettop(L)== n + 4:ns=>co=>cl=>st
             m_pLuaVm->AddStackSize(1);
 
+            //__index查找表在类修改结束(EndClass)前失效
+            UpdateIndexMetaMethods(false);
             //now stack栈状态lua_gettop(L) == n + 4:ns=>co=>cl=>st
         }
     }
@@ -441,14 +666,18 @@ public:
         assert (lua_istable(L, -1)); // Stack: namespace table (ns)
 
         CreateConstTable(name); // Stack: ns, const table (co)
-        lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); // Stack: ns, co, function
-        LuaHelper::RawSetField(L, -2, "__gc"); // Stack: ns, co
+        if (Userdata::NeedsGcMetaMethod<T>(shared)) {
+            lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); // Stack: ns, co, function
+            LuaHelper::RawSetField(L, -2, "__gc"); // Stack: ns, co
+        }
         m_pLuaVm->AddStackSize(1);
 
 
         CreateClassTable(name); // Stack: ns, co, class table (cl)
-        lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); // Stack: ns, co, cl, function
-        LuaHelper::RawSetField(L, -2, "__gc"); // Stack: ns, co, cl
+        if (Userdata::NeedsGcMetaMethod<T>(shared)) {
+            lua_pushcfunction(L, &CFunc::GCMetaMethod<T>); // Stack: ns, co, cl, function
+            LuaHelper::RawSetField(L, -2, "__gc"); // Stack: ns, co, cl
+        }
         m_pLuaVm->AddStackSize(1);
 
 
@@ -499,11 +728,69 @@ public:
     void EndClass()
     {
         assert (m_pLuaVm->GetStackSize() > 3);
+        UpdateIndexMetaMethods(true);
         m_pLuaVm->AddStackSize(-3);
         lua_State *L = m_pLuaVm->LuaState();
         lua_pop(L, 3);
     }
 
+    //--------------------------------------------------------------------------
+    /**
+      Opt in to flattened dispatch.
+
+      At EndClass () the members of the class and all of its parents are merged
+      into one lookup table, so obj.member costs one raw get regardless of the
+      depth of the class hierarchy. The merged table is rebuilt whenever the class
+      or one of its parents is reopened and extended.
+    */
+    Class<T> &EnableFlatDispatch()
+    {
+        m_bFlatDispatch = true;
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Opt in to the pointer identity cache.
+
+      Pushing the same T* (or container of T) again returns the userdata that
+      already exists for it instead of allocating a new one, so == compares
+      objects by identity. The cache holds its userdata weakly. When C++
+      destroys an object that may still be cached, call
+      Userdata::Invalidate<T> (L, p) so a later object at the same address
+      does not reuse the stale userdata.
+    */
+    Class<T> &EnableIdentityCache()
+    {
+        lua_State *L = m_pLuaVm->LuaState();
+        CreateIdentityCache(L, -3); // Stack: co, cl, st
+        CreateIdentityCache(L, -2);
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Opt in to object accounting.
+
+      Counts live objects, objects created and bytes of live userdata of the
+      class, read them with ClassInfo<T>::GetTypeInfo ()->GetStats (),
+      ClassTypeInfo::Snapshot () or from lua with LuaBridge::RegisterClassStats.
+      Enable it at registration, before objects of the class are pushed. The
+      class gets a __gc metamethod if it had none.
+    */
+    Class<T> &EnableStats()
+    {
+        lua_State *L = m_pLuaVm->LuaState();
+        ClassInfo<T>::GetTypeInfo()->EnableStats(className);
+        lua_pushvalue(L, -3); // Stack: co, cl, st, co
+        Userdata::EnsureGcMetaMethod<T>(L);
+        lua_pop(L, 1); // Stack: co, cl, st
+        lua_pushvalue(L, -2); // Stack: co, cl, st, cl
+        Userdata::EnsureGcMetaMethod<T>(L);
+        lua_pop(L, 1); // Stack: co, cl, st
+        return *this;
+    }
+
     //--------------------------------------------------------------------------
     /**
       Add or replace a static data member.
@@ -541,6 +828,43 @@ public:
         return *this;
     }
 
+    //--------------------------------------------------------------------------
+    /**
+      Add or replace a static constant.
+
+      The value is copied into the constants table of the class, reads are
+      resolved by the Lua VM without a C call and writes raise a lua error.
+    */
+    template<class U>
+    Class<T> &AddConstant(char const *name, U value)
+    {
+        AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
+        lua_State *L = m_pLuaVm->LuaState();
+
+        Stack<U>::push(L, value); // Stack: co, cl, st, value
+        CFunc::AddConstant(L, name, -2); // Stack: co, cl, st
+
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Add or replace a nested enum, see Enum.
+
+      Sample: AddEnum<A::State>("State", {{"Idle", A::Idle}, {"Run", A::Run}})
+    */
+    template<class E>
+    Class<T> &AddEnum(char const *name, std::initializer_list<typename Enum<E>::Value> values)
+    {
+        AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
+        lua_State *L = m_pLuaVm->LuaState();
+
+        Enum<E>::push(L, name, values.begin(), values.end()); // Stack: co, cl, st, enum
+        CFunc::AddConstant(L, name, -2); // Stack: co, cl, st
+
+        return *this;
+    }
+
     //--------------------------------------------------------------------------
     /**
       Add or replace a static property member.
@@ -580,6 +904,7 @@ public:
         AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
         lua_State *L = m_pLuaVm->LuaState();
 
+        CFunc::RemoveConstant(L, name, -1); // co, cl, st
         lua_pushlightuserdata(L, reinterpret_cast <void *> (fp)); // Stack: co, cl, st, function ptr
         lua_pushcclosure(L, &CFunc::Call<FP>::f, 1); // co, cl, st, function
         LuaHelper::RawSetField(L, -2, name); // co, cl, st
@@ -605,6 +930,7 @@ public:
         AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
         lua_State *L = m_pLuaVm->LuaState();
 
+        CFunc::RemoveConstant(L, name, -1); // co, cl, st
         lua_pushcfunction(L, fp); // co, cl, st, function
         LuaHelper::RawSetField(L, -2, name); // co, cl, st
 
@@ -621,6 +947,37 @@ public:
         return AddData(name, mp, isWritable);
     }
 
+    //--------------------------------------------------------------------------
+    /**
+      Add or replace a data member bound at compile time.
+
+      The pointer-to-member is a template argument, so the getter and setter
+      have no upvalue, see CLASS_ADD_DATA_T.
+      Sample: AddData<decltype(&A::x), &A::x>("x")
+    */
+    template<class MemPtr, MemPtr mp>
+    Class<T> &AddData(char const *name, bool isWritable = true)
+    {
+        typedef typename DataMemberTraits<MemPtr>::DataType U;
+        static_assert(std::is_same<typename DataMemberTraits<MemPtr>::ClassType, T>::value,
+                      "AddData data member of another class");
+
+        AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
+        lua_State *L = m_pLuaVm->LuaState();
+
+        PropertyAccessor::push(L, &StaticDataMemberAccessor<T, U, mp>::Get); // Stack: co, cl, st, getter
+        lua_pushvalue(L, -1); // Stack: co, cl, st, getter, getter
+        CFunc::AddGetter(L, name, -5); // Stack: co, cl, st, getter
+        CFunc::AddGetter(L, name, -3); // Stack: co, cl, st
+
+        if (isWritable) {
+            PropertyAccessor::push(L, &StaticDataMemberAccessor<T, U, mp>::Set); // Stack: co, cl, st, setter
+            CFunc::AddSetter(L, name, -3); // Stack: co, cl, st
+        }
+
+        return *this;
+    }
+
     //--------------------------------------------------------------------------
     /**
       Add or replace a data member.
@@ -631,16 +988,14 @@ public:
         AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
         lua_State *L = m_pLuaVm->LuaState();
 
-        typedef const U T::*mp_t;
-        new(lua_newuserdata(L, sizeof(mp_t))) mp_t(mp); // Stack: co, cl, st, field ptr
-        lua_pushcclosure(L, &CFunc::getProperty<T, U>, 1); // Stack: co, cl, st, getter
+        typedef DataMemberAccessor<T, U> accessor_t;
+        accessor_t::push(L, mp, &accessor_t::Get); // Stack: co, cl, st, getter
         lua_pushvalue(L, -1); // Stack: co, cl, st, getter, getter
         CFunc::AddGetter(L, name, -5); // Stack: co, cl, st, getter
         CFunc::AddGetter(L, name, -3); // Stack: co, cl, st
 
         if (isWritable) {
-            new(lua_newuserdata(L, sizeof(mp_t))) mp_t(mp); // Stack: co, cl, st, field ptr
-            lua_pushcclosure(L, &CFunc::setProperty<T, U>, 1); // Stack: co, cl, st, setter
+            accessor_t::push(L, mp, &accessor_t::Set); // Stack: co, cl, st, setter
             CFunc::AddSetter(L, name, -3); // Stack: co, cl, st
         }
 
@@ -657,17 +1012,14 @@ public:
         AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
         lua_State *L = m_pLuaVm->LuaState();
 
-        typedef TG (T::*get_t)() const;
-        new(lua_newuserdata(L, sizeof(get_t))) get_t(get); // Stack: co, cl, st, funcion ptr
-        lua_pushcclosure(L, &CFunc::CallConstMember<get_t>::f, 1); // Stack: co, cl, st, getter
+        typedef MemberPropertyAccessor<T, TG, TS> accessor_t;
+        accessor_t::push(L, get, set, &accessor_t::Get); // Stack: co, cl, st, getter
         lua_pushvalue(L, -1); // Stack: co, cl, st, getter, getter
         CFunc::AddGetter(L, name, -5); // Stack: co, cl, st, getter
         CFunc::AddGetter(L, name, -3); // Stack: co, cl, st
 
         if (set != 0) {
-            typedef void (T::* set_t)(TS);
-            new(lua_newuserdata(L, sizeof(set_t))) set_t(set); // Stack: co, cl, st, function ptr
-            lua_pushcclosure(L, &CFunc::CallMember<set_t>::f, 1); // Stack: co, cl, st, setter
+            accessor_t::push(L, get, set, &accessor_t::Set); // Stack: co, cl, st, setter
             CFunc::AddSetter(L, name, -3); // Stack: co, cl, st
         }
 
@@ -842,6 +1194,31 @@ public:
         return *this;
     }
 
+    //--------------------------------------------------------------------------
+    /**
+        Add or replace a member function bound at compile time.
+
+        The member function pointer is a template argument, so the thunk has no
+        upvalue and the call can be inlined, see CLASS_ADD_FUNC_T.
+        Sample: AddFunction<decltype(&A::Get), &A::Get>("Get")
+    */
+    template<class MemFn, MemFn mf>
+    Class<T> &AddFunction(char const *name)
+    {
+        static_assert(std::is_same<typename FuncTraits<MemFn>::ClassType, T>::value,
+                      "AddFunction member function of another class");
+
+        AssertStackState(); // Stack: const table (co), class table (cl), static table (st)
+        lua_State *L = m_pLuaVm->LuaState();
+
+        static const std::string GC = "__gc";
+        if (name == GC) {
+            throw std::logic_error(GC + " metamethod registration is forbidden");
+        }
+        CFunc::CallMemberFunctionHelperT<MemFn, mf, FuncTraits<MemFn>::isConstMemberFunction>::add(L, name);
+        return *this;
+    }
+
     //--------------------------------------------------------------------------
     /**
         Add or replace a member function.
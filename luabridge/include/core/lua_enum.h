@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef __LUA_ENUM_H__
+#define __LUA_ENUM_H__
+
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include "lua_library.h"
+#include "lua_helpers.h"
+#include "lua_stack.h"
+#include "lua_functions.h"
+#include "lua_vm.h"
+
+namespace luabridge
+{
+
+/**
+ * 枚举表,枚举值作为整数放在lua表中
+ *
+ * The enum is an empty read only table whose metatable __index is the value
+ * table, so Color.Red is resolved by the Lua VM through a table __index with
+ * no C call. The value table also holds the reverse mapping, Color[1] returns
+ * "Red" (the first name registered for the value), and pairs (Color) iterates
+ * it. Writes raise a lua error.
+ *
+ * Enum values are passed to and from bound functions as integers, see the
+ * Stack specialization for enums.
+ *
+ * Sample:  ns.BeginEnum<Color>("Color")
+ *              .AddValue("Red", Red)
+ *              .AddValue("Green", Green)
+ *              .EndEnum();
+ * @tparam E
+ */
+template<class E>
+class Enum
+{
+public:
+    typedef std::pair<const char *, E> Value;
+
+    Enum(const char *name, LuaVm *luaVm)
+        : m_pLuaVm(luaVm), m_name(name)
+    {
+    }
+
+    Enum<E> &AddValue(const char *name, E value)
+    {
+        m_values.push_back(Value(name, value));
+        return *this;
+    }
+
+    /**
+     * Install the enum in the namespace at the top of the stack.
+     */
+    void EndEnum()
+    {
+        lua_State *L = m_pLuaVm->LuaState();
+        LUA_ASSERT_EX(L, lua_istable(L, -1), "EndEnum lua_istable(L, -1)", false); // Stack: namespace table (ns)
+        push(L, m_name, m_values.begin(), m_values.end()); // Stack: ns, enum
+        if (m_pLuaVm->GetStackSize() == 1) {
+            // The global namespace has no propget table
+            LuaHelper::RawSetField(L, -2, m_name); // Stack: ns
+        }
+        else {
+            CFunc::AddConstant(L, m_name, -2); // Stack: ns
+        }
+    }
+
+    /**
+     * Push a new enum table built from the values in [begin, end).
+     */
+    template<class Iter>
+    static void push(lua_State *L, const char *name, Iter begin, Iter end)
+    {
+        int count = static_cast<int>(end - begin);
+        lua_newtable(L); // Stack: enum
+        lua_createtable(L, 0, 3); // Stack: enum, mt
+        lua_createtable(L, 0, count * 2); // Stack: enum, mt, value table (vt)
+        for (Iter it = begin; it != end; ++it) {
+            Stack<E>::push(L, it->second); // Stack: enum, mt, vt, value
+            LuaHelper::RawSetField(L, -2, it->first); // vt[name] = value. Stack: enum, mt, vt
+            Stack<E>::push(L, it->second); // Stack: enum, mt, vt, value
+            if (lua_rawget(L, -2) == LUA_TNIL) // Stack: enum, mt, vt, vt[value]
+            {
+                Stack<E>::push(L, it->second); // Stack: enum, mt, vt, nil, value
+                lua_pushstring(L, it->first); // Stack: enum, mt, vt, nil, value, name
+                lua_rawset(L, -4); // vt[value] = name. Stack: enum, mt, vt, nil
+            }
+            lua_pop(L, 1); // Stack: enum, mt, vt
+        }
+        LuaHelper::RawSetField(L, -2, "__index"); // mt.__index = vt. Stack: enum, mt
+
+        lua_pushstring(L, name); // Stack: enum, mt, name
+        lua_pushcclosure(L, &CFunc::ReadOnlyError, 1); // Stack: enum, mt, error_fn
+        LuaHelper::RawSetField(L, -2, "__newindex"); // Stack: enum, mt
+
+        lua_pushcfunction(L, &Enum<E>::Pairs); // Stack: enum, mt, pairs
+        LuaHelper::RawSetField(L, -2, "__pairs"); // Stack: enum, mt
+        lua_setmetatable(L, -2); // Stack: enum
+    }
+
+private:
+    /**
+     * __pairs = function(t) return next, vt, nil end
+     */
+    static int Pairs(lua_State *L)
+    {
+        lua_pushcfunction(L, &Enum<E>::Next); // Stack: enum, next
+        lua_getmetatable(L, 1); // Stack: enum, next, mt
+        LuaHelper::RawGetField(L, -1, "__index"); // Stack: enum, next, mt, vt
+        lua_remove(L, -2); // Stack: enum, next, vt
+        lua_pushnil(L); // Stack: enum, next, vt, nil
+        return 3;
+    }
+
+    static int Next(lua_State *L)
+    {
+        lua_settop(L, 2); // Stack: vt, key
+        if (lua_next(L, 1)) // Stack: vt, next key, value
+        {
+            return 2;
+        }
+        lua_pushnil(L); // Stack: vt, nil
+        return 1;
+    }
+
+private:
+    LuaVm *m_pLuaVm;
+    const char *m_name;
+    std::vector<Value> m_values;
+};
+
+} // namespace luabridge
+
+#endif
@@ -0,0 +1,229 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef __LUA_FUNCTION_REF_H__
+#define __LUA_FUNCTION_REF_H__
+
+#include <stdexcept>
+#include <string>
+#include "lua_library.h"
+#include "lua_helpers.h"
+#include "lua_stack.h"
+
+namespace luabridge
+{
+
+/**
+ * 取出lua函数的返回值并恢复调用前的堆栈
+ * @tparam R
+ */
+template<class R>
+struct LuaFunctionResult
+{
+    static const int count = StackCount<R>::value;
+
+    static R get(lua_State *L, const char *func, int top)
+    {
+        try {
+            R r = Stack<R>::get(L, -count, false);
+            lua_settop(L, top);
+            return r;
+        }
+        catch (std::exception &e) {
+            lua_settop(L, top);
+            LuaHelper::DebugCallFuncErrorStack(L, func, e.what());
+            return R();
+        }
+    }
+
+    static R fail()
+    {
+        return R();
+    }
+};
+
+template<>
+struct LuaFunctionResult<void>
+{
+    static const int count = 0;
+
+    static void get(lua_State *L, const char *func, int top)
+    {
+        (void) func;
+        lua_settop(L, top);
+    }
+
+    static void fail()
+    {
+    }
+};
+
+template<class FT>
+class LuaFunction;
+
+/**
+ * 预先解析的lua函数句柄
+ *
+ * The global function is looked up once and kept as a registry reference, so
+ * a call is a lua_rawgeti plus lua_pcall with no string hashing and no global
+ * table lookup. Errors are reported like LuaBridge::CallLuaFunc and the
+ * call returns R (). Calling a handle that is not bound throws
+ * std::runtime_error.
+ *
+ * The handle keeps calling the function it resolved, call Rebind () after a
+ * script reload to pick up the new definition. The handle must not outlive
+ * its lua_State.
+ *
+ * Sample:  LuaFunction<int(int, const char *)> onMessage(L, "on_message");
+ *          int ret = onMessage(1, "hello");
+ */
+template<class R, class... Args>
+class LuaFunction<R(Args...)>
+{
+private:
+    LuaFunction(const LuaFunction &);
+    LuaFunction &operator=(const LuaFunction &);
+
+public:
+    LuaFunction()
+        : m_L(NULL), m_ref(LUA_NOREF)
+    {
+    }
+
+    LuaFunction(lua_State *L, const char *name)
+        : m_L(L), m_ref(LUA_NOREF), m_name(name)
+    {
+        Rebind();
+    }
+
+    LuaFunction(LuaFunction &&other)
+        : m_L(other.m_L), m_ref(other.m_ref), m_name(std::move(other.m_name))
+    {
+        other.m_ref = LUA_NOREF;
+    }
+
+    LuaFunction &operator=(LuaFunction &&other)
+    {
+        if (this != &other) {
+            Release();
+            m_L = other.m_L;
+            m_ref = other.m_ref;
+            m_name = std::move(other.m_name);
+            other.m_ref = LUA_NOREF;
+        }
+        return *this;
+    }
+
+    ~LuaFunction()
+    {
+        Release();
+    }
+
+    /**
+     * Resolve the global function again, call this after the script is reloaded.
+     * @return true if the global is a function
+     */
+    bool Rebind()
+    {
+        Release();
+        if (m_L == NULL) {
+            return false;
+        }
+        lua_getglobal(m_L, m_name.c_str());
+        if (!lua_isfunction(m_L, -1)) {
+            lua_pop(m_L, 1);
+            return false;
+        }
+        m_ref = luaL_ref(m_L, LUA_REGISTRYINDEX);
+        return true;
+    }
+
+    /**
+     * Bind the handle to another global function.
+     */
+    bool Rebind(lua_State *L, const char *name)
+    {
+        Release();
+        m_L = L;
+        m_name = name;
+        return Rebind();
+    }
+
+    bool IsValid() const
+    {
+        return m_ref != LUA_NOREF;
+    }
+
+    const std::string &Name() const
+    {
+        return m_name;
+    }
+
+    R operator()(Args... args) const
+    {
+        if (!IsValid()) {
+            // m_L may be NULL for a default constructed handle
+            throw std::runtime_error("function is not bound: " + m_name);
+        }
+        int top = lua_gettop(m_L);
+        try {
+            lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_ref);
+            int dummy[] = {0, (Stack<Args>::push(m_L, args), 0)...};
+            (void) dummy;
+        }
+        catch (...) {
+            // A failed push leaves the function and the arguments pushed so far
+            lua_settop(m_L, top);
+            throw;
+        }
+        if (lua_pcall(m_L, sizeof...(Args), LuaFunctionResult<R>::count, 0) != LUA_OK) {
+            LuaHelper::DebugCallFuncErrorStack(m_L, m_name.c_str(), lua_tostring(m_L, -1));
+            lua_settop(m_L, top);
+            return LuaFunctionResult<R>::fail();
+        }
+        return LuaFunctionResult<R>::get(m_L, m_name.c_str(), top);
+    }
+
+private:
+    void Release()
+    {
+        if (m_L != NULL && m_ref != LUA_NOREF) {
+            luaL_unref(m_L, LUA_REGISTRYINDEX, m_ref);
+        }
+        m_ref = LUA_NOREF;
+    }
+
+private:
+    lua_State *m_L;
+    int m_ref;
+    std::string m_name;
+};
+
+} // namespace luabridge
+
+#endif
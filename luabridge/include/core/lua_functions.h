@@ -33,20 +33,187 @@
 #define __LUA_FUNCTION_H__
 
 #include <string>
+#include <vector>
 #include "func_traits.h"
 #include "lua_library.h"
 
 namespace luabridge
 {
 
+/**
+ * 属性访问器,代替getter/setter闭包存放在propget/propset表中
+ *
+ * The __index and __newindex metamethods call fn on their own frame, so a
+ * property access is one C call instead of the metamethod plus a nested
+ * lua_call of the getter or setter closure. obj is the stack index of the
+ * object, value the index of the new value (0 for getters). A getter pushes
+ * exactly one value.
+ */
+struct PropertyAccessor
+{
+    typedef void (*Function)(lua_State *L, int obj, int value, const PropertyAccessor *self);
+    Function fn;
+
+    /**
+     * Push a new accessor without extra data.
+     */
+    static void push(lua_State *L, Function fn)
+    {
+        PropertyAccessor *accessor = static_cast<PropertyAccessor *>(lua_newuserdata(L, sizeof(PropertyAccessor)));
+        accessor->fn = fn;
+    }
+
+    static bool Is(lua_State *L, int index)
+    {
+        return lua_type(L, index) == LUA_TUSERDATA;
+    }
+
+    /**
+     * Call the getter at index, the value is pushed.
+     */
+    static void Get(lua_State *L, int index, int obj)
+    {
+        const PropertyAccessor *self = static_cast<const PropertyAccessor *>(lua_touserdata(L, index));
+        self->fn(L, obj, 0, self);
+    }
+
+    /**
+     * Call the setter at index.
+     */
+    static void Set(lua_State *L, int index, int obj, int value)
+    {
+        const PropertyAccessor *self = static_cast<const PropertyAccessor *>(lua_touserdata(L, index));
+        self->fn(L, obj, value, self);
+    }
+};
+
+/**
+ * 数据成员访问器,成员指针存放在访问器中
+ * @tparam C
+ * @tparam T
+ */
+template<class C, typename T>
+struct DataMemberAccessor : PropertyAccessor
+{
+    T C::* mp;
+
+    static void push(lua_State *L, T C::* mp, Function fn)
+    {
+        DataMemberAccessor *accessor = static_cast<DataMemberAccessor *>(lua_newuserdata(L, sizeof(DataMemberAccessor)));
+        accessor->fn = fn;
+        accessor->mp = mp;
+    }
+
+    static void Get(lua_State *L, int obj, int, const PropertyAccessor *self)
+    {
+        C *const c = Userdata::get<C>(L, obj, true);
+        try {
+            Stack<T &>::push(L, c->*static_cast<const DataMemberAccessor *>(self)->mp);
+        }
+        catch (const std::exception &e) {
+            luaL_error(L, e.what());
+        }
+    }
+
+    static void Set(lua_State *L, int obj, int value, const PropertyAccessor *self)
+    {
+        C *const c = Userdata::get<C>(L, obj, false);
+        try {
+            c->*static_cast<const DataMemberAccessor *>(self)->mp = Stack<T>::get(L, value);
+        }
+        catch (const std::exception &e) {
+            luaL_error(L, e.what());
+        }
+    }
+};
+
+/**
+ * 编译期绑定的数据成员访问器,成员指针是模板参数
+ * @tparam C
+ * @tparam T
+ * @tparam mp
+ */
+template<class C, typename T, T C::* mp>
+struct StaticDataMemberAccessor
+{
+    static void Get(lua_State *L, int obj, int, const PropertyAccessor *)
+    {
+        C *const c = Userdata::get<C>(L, obj, true);
+        try {
+            Stack<T &>::push(L, c->*mp);
+        }
+        catch (const std::exception &e) {
+            luaL_error(L, e.what());
+        }
+    }
+
+    static void Set(lua_State *L, int obj, int value, const PropertyAccessor *)
+    {
+        C *const c = Userdata::get<C>(L, obj, false);
+        try {
+            c->*mp = Stack<T>::get(L, value);
+        }
+        catch (const std::exception &e) {
+            luaL_error(L, e.what());
+        }
+    }
+};
+
+/**
+ * 成员函数属性访问器,TG (C::*)() const 和 void (C::*)(TS)
+ * @tparam C
+ * @tparam TG
+ * @tparam TS
+ */
+template<class C, class TG, class TS>
+struct MemberPropertyAccessor : PropertyAccessor
+{
+    typedef TG (C::*GetType)() const;
+    typedef void (C::*SetType)(TS);
+    GetType get;
+    SetType set;
+
+    static void push(lua_State *L, GetType get, SetType set, Function fn)
+    {
+        MemberPropertyAccessor *accessor =
+            static_cast<MemberPropertyAccessor *>(lua_newuserdata(L, sizeof(MemberPropertyAccessor)));
+        accessor->fn = fn;
+        accessor->get = get;
+        accessor->set = set;
+    }
+
+    static void Get(lua_State *L, int obj, int, const PropertyAccessor *self)
+    {
+        C const *const c = Userdata::get<C>(L, obj, true);
+        try {
+            Stack<TG>::push(L, (c->*static_cast<const MemberPropertyAccessor *>(self)->get)());
+        }
+        catch (const std::exception &e) {
+            luaL_error(L, e.what());
+        }
+    }
+
+    static void Set(lua_State *L, int obj, int value, const PropertyAccessor *self)
+    {
+        C *const c = Userdata::get<C>(L, obj, false);
+        try {
+            (c->*static_cast<const MemberPropertyAccessor *>(self)->set)(Stack<TS>::get(L, value));
+        }
+        catch (const std::exception &e) {
+            luaL_error(L, e.what());
+        }
+    }
+};
+
 // We use a structure so we can define everything in the header.
 //
 struct CFunc
 {
     static void AddGetter(lua_State *L, const char *name, int tableIndex)
     {
+        RemoveConstant(L, name, tableIndex);
         assert (lua_istable(L, tableIndex));
-        assert (lua_iscfunction(L, -1)); // Stack: getter
+        assert (lua_iscfunction(L, -1) || PropertyAccessor::Is(L, -1)); // Stack: getter
 
         lua_rawgetp(L, tableIndex, GetPropgetKey()); // Stack: getter, propget table (pg)
         lua_pushvalue(L, -2); // Stack: getter, pg, getter
@@ -54,10 +221,38 @@ struct CFunc
         lua_pop (L, 2); // Stack: -
     }
 
+    /**
+        Drop a constant replaced by another member of the same name, the
+        constants table is looked up before the namespace or static table.
+    */
+    static void RemoveConstant(lua_State *L, const char *name, int tableIndex)
+    {
+        LuaHelper::RawGetField(L, tableIndex, "__index"); // Stack: constants table (ct) | other
+        if (IsConstantsTable(L, -1)) {
+            lua_pushnil(L); // Stack: ct, nil
+            LuaHelper::RawSetField(L, -2, name); // Stack: ct
+        }
+        lua_pop(L, 1); // Stack: -
+    }
+
+    /**
+        Whether the value at index is a constants table, see AddConstant.
+    */
+    static bool IsConstantsTable(lua_State *L, int index)
+    {
+        if (!lua_istable(L, index) || !lua_getmetatable(L, index)) {
+            return false;
+        }
+        LuaHelper::RawGetField(L, -1, "__index"); // Stack: ct mt, function | nil
+        bool is = lua_tocfunction(L, -1) == &CFunc::IndexConstantsMetaMethod;
+        lua_pop(L, 2); // Stack: -
+        return is;
+    }
+
     static void AddSetter(lua_State *L, const char *name, int tableIndex)
     {
         assert (lua_istable(L, tableIndex));
-        assert (lua_iscfunction(L, -1)); // Stack: setter
+        assert (lua_iscfunction(L, -1) || PropertyAccessor::Is(L, -1)); // Stack: setter
 
         lua_rawgetp(L, tableIndex, GetPropsetKey()); // Stack: setter, propset table (ps)
         lua_pushvalue(L, -2); // Stack: setter, ps, setter
@@ -65,6 +260,51 @@ struct CFunc
         lua_pop (L, 2); // Stack: -
     }
 
+    /**
+        Add a constant to the namespace or static table at tableIndex, the
+        value is at the top of the stack.
+
+        The value goes to the constants table, which becomes the __index of
+        the namespace or static table the first time: reads are resolved by
+        the VM through a table __index with no C call, like Enum. Names that
+        are not constants fall through to IndexConstantsMetaMethod. The value
+        is also stored in the propget table, so derived classes find it with
+        IndexMetaMethod, and a ReadOnlyError setter guards against writes.
+    */
+    static void AddConstant(lua_State *L, const char *name, int tableIndex)
+    {
+        tableIndex = lua_absindex(L, tableIndex);
+        assert (lua_istable(L, tableIndex));
+        int type = lua_type(L, -1); // Stack: value
+        LUA_ASSERT_EX(L, type != LUA_TNIL && type != LUA_TFUNCTION && type != LUA_TUSERDATA,
+                      "AddConstant value must be a number, string, boolean or table", false);
+
+        LuaHelper::RawGetField(L, tableIndex, "__index"); // Stack: value, constants table (ct) | IndexMetaMethod
+        if (!IsConstantsTable(L, -1)) {
+            lua_pop(L, 1); // Stack: value
+            lua_newtable(L); // Stack: value, ct
+            lua_createtable(L, 0, 1); // Stack: value, ct, ct mt
+            lua_pushvalue(L, tableIndex); // Stack: value, ct, ct mt, table
+            lua_pushcclosure(L, &CFunc::IndexConstantsMetaMethod, 1); // Stack: value, ct, ct mt, function
+            LuaHelper::RawSetField(L, -2, "__index"); // Stack: value, ct, ct mt
+            lua_setmetatable(L, -2); // Stack: value, ct
+            lua_pushvalue(L, -1); // Stack: value, ct, ct
+            LuaHelper::RawSetField(L, tableIndex, "__index"); // Stack: value, ct
+        }
+        lua_pushvalue(L, -2); // Stack: value, ct, value
+        LuaHelper::RawSetField(L, -2, name); // Stack: value, ct
+        lua_pop(L, 1); // Stack: value
+
+        lua_rawgetp(L, tableIndex, GetPropgetKey()); // Stack: value, propget table (pg)
+        lua_insert(L, -2); // Stack: pg, value
+        LuaHelper::RawSetField(L, -2, name); // Stack: pg
+        lua_pop(L, 1); // Stack: -
+
+        lua_pushstring(L, name); // Stack: name
+        lua_pushcclosure(L, &CFunc::ReadOnlyError, 1); // Stack: error_fn
+        AddSetter(L, name, tableIndex); // Stack: -
+    }
+
     //----------------------------------------------------------------------------
     /**
         __index metamethod for a namespace or class static and non-static members.
@@ -83,6 +323,31 @@ struct CFunc
         //mt = tu.__metatable 栈状态lua_gettop(L) == 3:tu=>field name=>mt
         LUA_ASSERT (L, lua_istable(L, -1), "lua_istable(L, 1)");
 
+        return IndexLookup(L);
+    }
+
+    //----------------------------------------------------------------------------
+    /**
+        __index of the constants table of a namespace or static table.
+
+        Constants are found by the VM in the constants table itself, this is
+        only called for other names. The namespace or static table is the
+        upvalue, the lookup continues there like in IndexMetaMethod.
+    */
+    static int IndexConstantsMetaMethod(lua_State *L)
+    {
+        lua_settop(L, 2); // Stack: constants table (ct), field name
+        lua_pushvalue(L, lua_upvalueindex(1)); // Stack: ct, field name, mt
+        return IndexLookup(L);
+    }
+
+    //----------------------------------------------------------------------------
+    /**
+        The lookup of IndexMetaMethod, from the metatable at index 3 up through
+        its parents. Stack: tu, field name, mt
+    */
+    static int IndexLookup(lua_State *L)
+    {
         for (;;) {
             lua_pushvalue(L, 2); // 栈状态lua_gettop(L)==4:tu=>field name =>mt =>field name
             lua_rawget(L, -2);  //func = mt[field name] 栈状态lua_gettop(L) == 4:tu=>field name=>mt=>func
@@ -122,6 +387,19 @@ struct CFunc
                 return 1;
             }
 
+            //找到了name对应的属性访问器,在当前栈帧直接调用
+            if (PropertyAccessor::Is(L, -1)) // 栈状态lua_gettop(L) == 4:tu=>field name=>mt=>accessor
+            {
+                PropertyAccessor::Get(L, -1, 1); //栈状态lua_gettop(L) == 5:tu=>field name=>mt=>accessor=>value
+                return 1;
+            }
+
+            //找到了name对应的常量,直接返回
+            if (!lua_isnil(L, -1)) // 栈状态lua_gettop(L) == 4:tu=>field name=>mt=>value
+            {
+                return 1;
+            }
+
             //没有找到了name对应getter的函数
             // 栈状态lua_gettop(L) == 4:tu=>field name=>mt=>nil
             LUA_ASSERT (L, lua_isnil(L, -1), "lua_isnil(L, -1)");
@@ -152,6 +430,35 @@ struct CFunc
         }
     }
 
+    //----------------------------------------------------------------------------
+    /**
+        __index metamethod for a class using flattened dispatch.
+
+        The merged lookup table built by ClassBase::BuildFlatTable is in the first
+        upvalue. Functions are returned as is, properties are stored as {getter}
+        where getter is a closure or a PropertyAccessor.
+        A miss means the member does not exist anywhere in the class hierarchy.
+        __index = function(t, k) {}
+    */
+    static int FlatIndexMetaMethod(lua_State *L)
+    {
+        //栈状态lua_gettop(L) == 2:tu(t)=>field name(k)
+        lua_pushvalue(L, 2); // Stack: tu, field name, field name
+        lua_rawget(L, lua_upvalueindex(1)); // Stack: tu, field name, func | {getter} | nil
+
+        if (lua_istable(L, -1)) // Stack: tu, field name, {getter}
+        {
+            lua_rawgeti(L, -1, 1); // Stack: tu, field name, {getter}, getter | accessor
+            if (PropertyAccessor::Is(L, -1)) {
+                PropertyAccessor::Get(L, -1, 1); // Stack: tu, field name, {getter}, accessor, value
+                return 1;
+            }
+            lua_pushvalue(L, 1); // Stack: tu, field name, {getter}, getter, tu
+            lua_call(L, 1, 1); // Stack: tu, field name, {getter}, value
+        }
+        return 1;
+    }
+
     //----------------------------------------------------------------------------
     /**
         __newindex metamethod for namespace or class static members.
@@ -206,6 +513,12 @@ struct CFunc
                 return 0;
             }
 
+            if (PropertyAccessor::Is(L, -1)) // Stack: mt, accessor
+            {
+                PropertyAccessor::Set(L, -1, 1, 3); // Stack: mt, accessor
+                return 0;
+            }
+
             assert (lua_isnil(L, -1)); // Stack: mt, nil
             lua_pop (L, 1); // Stack: mt
 
@@ -356,6 +669,39 @@ struct CFunc
         }
     };
 
+    //--------------------------------------------------------------------------
+    /**
+        lua_CFunction to call a class member function bound at compile time.
+
+        The member function pointer is a template argument, there is no upvalue.
+        The class userdata object is at the top of the Lua stack.
+    */
+    template<class MemFnPtr, MemFnPtr fn>
+    struct CallMemberT
+    {
+        typedef typename FuncTraits<MemFnPtr>::ClassType T;
+        typedef typename FuncTraits<MemFnPtr>::ReturnType ReturnType;
+
+        static int f(lua_State *L)
+        {
+            T *const t = Userdata::get<T>(L, 1, false);
+            return Invoke<ReturnType, 2>::run(L, t, fn);
+        }
+    };
+
+    template<class MemFnPtr, MemFnPtr fn>
+    struct CallConstMemberT
+    {
+        typedef typename FuncTraits<MemFnPtr>::ClassType T;
+        typedef typename FuncTraits<MemFnPtr>::ReturnType ReturnType;
+
+        static int f(lua_State *L)
+        {
+            T const *const t = Userdata::get<T>(L, 1, true);
+            return Invoke<ReturnType, 2>::run(L, t, fn);
+        }
+    };
+
     //--------------------------------------------------------------------------
     /**
         lua_CFunction to call a class member lua_CFunction.
@@ -449,6 +795,28 @@ struct CFunc
         }
     };
 
+    template<class MemFnPtr, MemFnPtr fn, bool isConst>
+    struct CallMemberFunctionHelperT
+    {
+        static void add(lua_State *L, char const *name)
+        {
+            lua_pushcfunction(L, (&CallConstMemberT<MemFnPtr, fn>::f));
+            lua_pushvalue(L, -1);
+            LuaHelper::RawSetField(L, -5, name); // const table
+            LuaHelper::RawSetField(L, -3, name); // class table
+        }
+    };
+
+    template<class MemFnPtr, MemFnPtr fn>
+    struct CallMemberFunctionHelperT<MemFnPtr, fn, false>
+    {
+        static void add(lua_State *L, char const *name)
+        {
+            lua_pushcfunction(L, (&CallMemberT<MemFnPtr, fn>::f));
+            LuaHelper::RawSetField(L, -3, name); // class table
+        }
+    };
+
     //--------------------------------------------------------------------------
     /**
         __gc metamethod for a class.
@@ -456,9 +824,28 @@ struct CFunc
     template<class C>
     static int GCMetaMethod(lua_State *L)
     {
-        Userdata *const ud = Userdata::getExact<C>(L, 1);
-        ud->~Userdata();
-        return 0;
+        return Userdata::GCMetaMethod<C>(L);
+    }
+
+    /**
+        Snapshot of the object counters of the classes with stats enabled.
+        Returns { [class name] = { live = n, created = n, bytes = n }, ... }
+    */
+    static int ClassStats(lua_State *L)
+    {
+        std::vector<ClassTypeInfo::Stats> stats = ClassTypeInfo::Snapshot();
+        lua_createtable(L, 0, static_cast<int>(stats.size())); // Stack: result
+        for (size_t i = 0; i < stats.size(); ++i) {
+            lua_createtable(L, 0, 3); // Stack: result, class stats (cs)
+            lua_pushinteger(L, static_cast<lua_Integer>(stats[i].live));
+            lua_setfield(L, -2, "live");
+            lua_pushinteger(L, static_cast<lua_Integer>(stats[i].created));
+            lua_setfield(L, -2, "created");
+            lua_pushinteger(L, static_cast<lua_Integer>(stats[i].bytes));
+            lua_setfield(L, -2, "bytes");
+            lua_setfield(L, -2, stats[i].name.c_str()); // Stack: result
+        }
+        return 1;
     }
 
     /**
@@ -542,7 +929,10 @@ struct LuaCFunctionWrapI<FUNCID, R (*)(ParamList...)>
     typedef typename ArgTypeList<ParamList...>::template args<0>::type ParType;
     inline lua_CFunction operator()(DeclType f)
     {
-        lua_function<DeclType, FUNCID>::fn = f;
+        // The slot is shared by every lua_State, registering again must not write while other states call it
+        if (lua_function<DeclType, FUNCID>::fn != f) {
+            lua_function<DeclType, FUNCID>::fn = f;
+        }
         return &lua_function<DeclType, FUNCID>::Call;
     }
 };
@@ -566,6 +956,22 @@ inline lua_CFunction LuaCFunctionWrap(Func f)
     return LuaCFunctionWrapI<FUNCID, Func>()(f);
 }
 
+/**
+ * 编译期绑定的c函数,函数指针是模板参数,没有静态可变的函数槽,也不取upvalue,
+ * 每个函数生成独立的lua_CFunction,编译器可以内联目标函数
+ * @tparam FnPtr 函数指针类型
+ * @tparam fn    函数指针
+ */
+template<class FnPtr, FnPtr fn>
+struct StaticCFunction
+{
+    static int Call(lua_State *L)
+    {
+        FnPtr fp = fn;
+        return Invoke<typename FuncTraits<FnPtr>::ReturnType, 1>::run(L, fp);
+    }
+};
+
 } // namespace luabridge
 
 #endif
\ No newline at end of file
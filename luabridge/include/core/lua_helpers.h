@@ -36,6 +36,7 @@
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <string>
 
 namespace luabridge
 {
@@ -55,6 +56,66 @@ struct BinaryStr
     int m_iLen;
 };
 
+/**
+ * 不拷贝的字符串参数,直接引用lua栈上字符串的内存,只在本次调用期间有效
+ * Non-owning view of a Lua string, the C++11 counterpart of std::string_view.
+ * */
+struct StringView
+{
+    StringView()
+        : m_pStr(""), m_iLen(0)
+    {
+    }
+
+    StringView(const char *pdata, size_t len)
+        : m_pStr(pdata), m_iLen(len)
+    {
+    }
+
+    StringView(const char *pdata)
+        : m_pStr(pdata), m_iLen(strlen(pdata))
+    {
+    }
+
+    StringView(const std::string &str)
+        : m_pStr(str.data()), m_iLen(str.size())
+    {
+    }
+
+    const char *data() const
+    {
+        return m_pStr;
+    }
+
+    size_t size() const
+    {
+        return m_iLen;
+    }
+
+    bool empty() const
+    {
+        return m_iLen == 0;
+    }
+
+    std::string ToString() const
+    {
+        return std::string(m_pStr, m_iLen);
+    }
+
+    bool operator==(const StringView &other) const
+    {
+        return m_iLen == other.m_iLen && memcmp(m_pStr, other.m_pStr, m_iLen) == 0;
+    }
+
+    bool operator!=(const StringView &other) const
+    {
+        return !(*this == other);
+    }
+
+    const char *m_pStr;
+    size_t m_iLen;
+};
+
 class LuaHelper
 {
 public:
@@ -111,6 +172,14 @@ public:
     */
     static bool IsFullUserData(lua_State *L, int index);
 
+    /** 64 bit FNV-1a hash of the bytes, used for script content and module names.
+    */
+    static unsigned long long HashBytes(const char *data, size_t size);
+
+    /** lua_Writer appending to the std::string ud, for lua_dump.
+    */
+    static int StringWriter(lua_State *L, const void *p, size_t sz, void *ud);
+
     /** Test lua_State objects for global equality.
         This can determine if two different lua_State objects really point
         to the same global state, such as when using coroutines.
@@ -360,6 +429,23 @@ void LuaHelper::RawSetField(lua_State *L, int index, char const *key)
     lua_rawset(L, index);
 }
 
+unsigned long long LuaHelper::HashBytes(const char *data, size_t size)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+int LuaHelper::StringWriter(lua_State *L, const void *p, size_t sz, void *ud)
+{
+    (void) L;
+    static_cast<std::string *>(ud)->append(static_cast<const char *>(p), sz);
+    return 0;
+}
+
 bool LuaHelper::IsFullUserData(lua_State *L, int index)
 {
     return lua_isuserdata(L, index) && !lua_islightuserdata (L, index);
@@ -0,0 +1,594 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef __LUA_SCHEMA_H__
+#define __LUA_SCHEMA_H__
+
+#include <cstring>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "lua_library.h"
+#include "lua_helpers.h"
+
+namespace luabridge
+{
+
+/**
+ * 绑定结构快照,注册一次后可以回放到任意新的lua_State
+ *
+ * Record () runs the registration on a scratch lua_State and captures every
+ * global and registry entry it added or changed, together with everything
+ * reachable from them: class, const and static tables, propget/propset
+ * tables, parents, lua_CFunction closures with their upvalues (member
+ * pointers, property accessors, names) and plain values. The result is a
+ * flat, immutable list of nodes. Replay () rebuilds it in one pass: tables
+ * are created presized, closures and upvalue userdata are copied, no
+ * registration code runs.
+ *
+ * What can't be recorded throws std::logic_error: Lua functions, threads,
+ * userdata with a metatable (std::function bindings, objects pushed during
+ * registration) and tables that existed before the registration other than
+ * _G. Those tables must not change either: the contents and metatables of
+ * every table reachable from _G and the registry are snapshotted, a field
+ * added to e.g. string or package.loaded throws instead of being dropped.
+ * Registry entries with integer keys (luaL_ref) are state specific and are
+ * skipped.
+ *
+ * Sample:  BindingSchema schema;
+ *          LuaBridge::RecordSchema(schema, RegisterAll);
+ *          LuaBridge lua;
+ *          lua.ReplaySchema(schema);
+ */
+class BindingSchema
+{
+private:
+    enum
+    {
+        VALUE_NIL,
+        VALUE_BOOLEAN,
+        VALUE_INTEGER,
+        VALUE_NUMBER,
+        VALUE_STRING,
+        VALUE_LIGHTUSERDATA,
+        VALUE_CFUNCTION,
+        VALUE_GLOBALS,
+        VALUE_NODE
+    };
+
+    enum
+    {
+        NODE_TABLE,
+        NODE_CLOSURE,
+        NODE_USERDATA
+    };
+
+    struct Value
+    {
+        int type;
+        union
+        {
+            int boolean;
+            lua_Integer integer;
+            lua_Number number;
+            size_t index;
+            void *pointer;
+            lua_CFunction function;
+        };
+    };
+
+    struct Node
+    {
+        int type;
+        int metatable;
+        int narr;
+        int nrec;
+        lua_CFunction function;
+        size_t first;
+        size_t count;
+    };
+
+    /**
+     * Recording state, only lives during Record ().
+     */
+    struct Recorder
+    {
+        lua_State *L;
+        const void *globals;
+        const void *registry;
+        int snapshots;
+        std::set<const void *> before;
+        std::unordered_map<const void *, int> nodes;
+    };
+
+public:
+    BindingSchema()
+    {
+    }
+
+    /**
+     * Run registration on L and record what it adds to the globals and the registry.
+     * L should be a fresh state, the schema replaces its previous content.
+     */
+    void Record(lua_State *L, const std::function<void()> &registration)
+    {
+        Clear();
+        Recorder recorder;
+        recorder.L = L;
+        lua_pushglobaltable(L); // Stack: _G
+        recorder.globals = lua_topointer(L, -1);
+        lua_pop(L, 1); // Stack: -
+
+        lua_newtable(L); // Stack: snapshots
+        recorder.snapshots = lua_gettop(L);
+        lua_pushvalue(L, LUA_REGISTRYINDEX); // Stack: snapshots, registry
+        recorder.registry = lua_topointer(L, -1);
+        MarkBefore(recorder, -1);
+        int registryCopy = ShallowCopy(L, -1); // Stack: snapshots, registry, registry copy
+        lua_pushglobaltable(L); // Stack: snapshots, registry, registry copy, _G
+        int globalsCopy = ShallowCopy(L, -1); // Stack: snapshots, registry, registry copy, _G, _G copy
+
+        registration();
+
+        CheckSnapshots(recorder);
+        RecordRoots(recorder, globalsCopy - 1, globalsCopy, false, m_globals);
+        RecordRoots(recorder, registryCopy - 1, registryCopy, true, m_registry);
+        lua_settop(L, recorder.snapshots - 1); // Stack: -
+    }
+
+    /**
+     * Rebuild the recorded bindings in L.
+     */
+    void Replay(lua_State *L) const
+    {
+        int base = lua_gettop(L);
+        LUA_ASSERT_EX(L, lua_checkstack(L, static_cast<int>(m_nodes.size()) + 8), "BindingSchema::Replay stack overflow", false);
+
+        // Tables first, closures and fields may refer to any of them
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const Node &node = m_nodes[i];
+            if (node.type == NODE_TABLE) {
+                lua_createtable(L, node.narr, node.nrec);
+            }
+            else if (node.type == NODE_USERDATA) {
+                memcpy(lua_newuserdata(L, node.count), m_blob.data() + node.first, node.count);
+            }
+            else {
+                lua_pushnil(L);
+            }
+        }
+        // Upvalues are recorded before their closure
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const Node &node = m_nodes[i];
+            if (node.type == NODE_CLOSURE) {
+                for (size_t j = 0; j < node.count; ++j) {
+                    Push(L, base, m_upvalues[node.first + j]);
+                }
+                lua_pushcclosure(L, node.function, static_cast<int>(node.count));
+                lua_replace(L, base + 1 + static_cast<int>(i));
+            }
+        }
+        // Metatables are set while all tables are still empty, like the registration does. A class
+        // metatable is its own metatable and holds __gc, set afterwards Lua would finalize the table
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const Node &node = m_nodes[i];
+            if (node.type == NODE_TABLE && node.metatable >= 0) {
+                lua_pushvalue(L, base + 1 + node.metatable);
+                lua_setmetatable(L, base + 1 + static_cast<int>(i));
+            }
+        }
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            const Node &node = m_nodes[i];
+            if (node.type != NODE_TABLE) {
+                continue;
+            }
+            int table = base + 1 + static_cast<int>(i);
+            for (size_t j = 0; j < node.count; ++j) {
+                Push(L, base, m_fields[(node.first + j) * 2]);
+                Push(L, base, m_fields[(node.first + j) * 2 + 1]);
+                lua_rawset(L, table);
+            }
+        }
+
+        lua_pushglobaltable(L); // Stack: nodes, _G
+        SetRoots(L, base, -1, m_globals);
+        lua_pop(L, 1); // Stack: nodes
+        SetRoots(L, base, LUA_REGISTRYINDEX, m_registry);
+        lua_settop(L, base);
+    }
+
+    void Clear()
+    {
+        m_nodes.clear();
+        m_fields.clear();
+        m_upvalues.clear();
+        m_globals.clear();
+        m_registry.clear();
+        m_strings.clear();
+        m_blob.clear();
+    }
+
+    bool Empty() const
+    {
+        return m_globals.empty() && m_registry.empty();
+    }
+
+    size_t NodeCount() const
+    {
+        return m_nodes.size();
+    }
+
+private:
+    /**
+     * Remember every table reachable from the value at index and snapshot its
+     * metatable and, except for _G and the registry whose new entries are
+     * recorded, its contents.
+     */
+    static void MarkBefore(Recorder &recorder, int index)
+    {
+        lua_State *L = recorder.L;
+        if (!lua_istable(L, index) || !recorder.before.insert(lua_topointer(L, index)).second) {
+            return;
+        }
+        index = lua_absindex(L, index);
+        lua_checkstack(L, 6);
+        const void *p = lua_topointer(L, index);
+        lua_pushvalue(L, index); // Stack: table
+        lua_createtable(L, 2, 0); // Stack: table, snapshot
+        if (p != recorder.globals && p != recorder.registry) {
+            ShallowCopy(L, index); // Stack: table, snapshot, copy
+            lua_rawseti(L, -2, 1); // Stack: table, snapshot
+        }
+        if (lua_getmetatable(L, index)) { // Stack: table, snapshot, mt
+            lua_rawseti(L, -2, 2); // Stack: table, snapshot
+        }
+        lua_rawset(L, recorder.snapshots); // Stack: -
+        if (lua_getmetatable(L, index)) {
+            MarkBefore(recorder, -1);
+            lua_pop(L, 1);
+        }
+        lua_pushnil(L);
+        while (lua_next(L, index)) {
+            MarkBefore(recorder, -2);
+            MarkBefore(recorder, -1);
+            lua_pop(L, 1);
+        }
+    }
+
+    /**
+     * Push a shallow copy of the table at index.
+     * @return the absolute index of the copy
+     */
+    static int ShallowCopy(lua_State *L, int index)
+    {
+        index = lua_absindex(L, index);
+        lua_newtable(L);
+        lua_pushnil(L);
+        while (lua_next(L, index)) {
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, -4);
+        }
+        return lua_gettop(L);
+    }
+
+    /**
+     * Throw if a table that existed before the registration got another
+     * metatable or, other than _G and the registry, other contents.
+     */
+    static void CheckSnapshots(Recorder &recorder)
+    {
+        lua_State *L = recorder.L;
+        lua_checkstack(L, 6);
+        lua_pushnil(L);
+        while (lua_next(L, recorder.snapshots)) // Stack: table, snapshot
+        {
+            int table = lua_gettop(L) - 1;
+            if (!lua_getmetatable(L, table)) { // Stack: table, snapshot, mt | nil
+                lua_pushnil(L);
+            }
+            lua_rawgeti(L, table + 1, 2); // Stack: table, snapshot, mt | nil, old mt | nil
+            bool changed = !lua_rawequal(L, -1, -2);
+            lua_pop(L, 2); // Stack: table, snapshot
+            if (!changed && lua_rawgeti(L, table + 1, 1) == LUA_TTABLE) { // Stack: table, snapshot, copy
+                changed = !SameContents(L, table, table + 2);
+            }
+            lua_settop(L, table); // Stack: table
+            if (changed) {
+                throw std::logic_error("BindingSchema can't record a change to a table created before the registration");
+            }
+        }
+    }
+
+    /**
+     * Whether the tables at index and copy hold the same entries.
+     */
+    static bool SameContents(lua_State *L, int index, int copy)
+    {
+        int count = 0;
+        lua_pushnil(L);
+        while (lua_next(L, index)) // Stack: key, value
+        {
+            ++count;
+            lua_pushvalue(L, -2); // Stack: key, value, key
+            lua_rawget(L, copy); // Stack: key, value, old value
+            bool same = lua_rawequal(L, -1, -2) != 0;
+            lua_pop(L, 2); // Stack: key
+            if (!same) {
+                lua_pop(L, 1); // Stack: -
+                return false;
+            }
+        }
+        lua_pushnil(L);
+        while (lua_next(L, copy)) {
+            --count;
+            lua_pop(L, 1);
+        }
+        return count == 0;
+    }
+
+    /**
+     * Record the entries of the table at index that are not in the copy made before.
+     */
+    void RecordRoots(Recorder &recorder, int index, int before, bool registry, std::vector<Value> &roots)
+    {
+        lua_State *L = recorder.L;
+        lua_pushnil(L);
+        while (lua_next(L, index)) // Stack: key, value
+        {
+            if (registry && lua_type(L, -2) == LUA_TNUMBER) {
+                lua_pop(L, 1);
+                continue;
+            }
+            lua_pushvalue(L, -2); // Stack: key, value, key
+            lua_rawget(L, before); // Stack: key, value, old value
+            bool changed = !lua_rawequal(L, -1, -2);
+            lua_pop(L, 1); // Stack: key, value
+            if (changed) {
+                roots.push_back(RecordValue(recorder, -2));
+                roots.push_back(RecordValue(recorder, -1));
+            }
+            lua_pop(L, 1); // Stack: key
+        }
+    }
+
+    Value RecordValue(Recorder &recorder, int index)
+    {
+        lua_State *L = recorder.L;
+        index = lua_absindex(L, index);
+        Value value;
+        value.type = VALUE_NIL;
+        value.integer = 0;
+        switch (lua_type(L, index)) {
+            case LUA_TNIL:
+                break;
+            case LUA_TBOOLEAN:
+                value.type = VALUE_BOOLEAN;
+                value.boolean = lua_toboolean(L, index);
+                break;
+            case LUA_TNUMBER:
+                if (lua_isinteger(L, index)) {
+                    value.type = VALUE_INTEGER;
+                    value.integer = lua_tointeger(L, index);
+                }
+                else {
+                    value.type = VALUE_NUMBER;
+                    value.number = lua_tonumber(L, index);
+                }
+                break;
+            case LUA_TSTRING: {
+                size_t len = 0;
+                const char *str = lua_tolstring(L, index, &len);
+                value.type = VALUE_STRING;
+                value.index = m_strings.size();
+                m_strings.push_back(std::string(str, len));
+                break;
+            }
+            case LUA_TLIGHTUSERDATA:
+                value.type = VALUE_LIGHTUSERDATA;
+                value.pointer = lua_touserdata(L, index);
+                break;
+            case LUA_TFUNCTION:
+                if (!lua_iscfunction(L, index)) {
+                    throw std::logic_error("BindingSchema can't record a Lua function");
+                }
+                if (lua_getupvalue(L, index, 1) == NULL) {
+                    value.type = VALUE_CFUNCTION;
+                    value.function = lua_tocfunction(L, index);
+                    break;
+                }
+                lua_pop(L, 1);
+                value.type = VALUE_NODE;
+                value.index = static_cast<size_t>(RecordObject(recorder, index));
+                break;
+            case LUA_TTABLE:
+                if (lua_topointer(L, index) == recorder.globals) {
+                    value.type = VALUE_GLOBALS;
+                    break;
+                }
+                if (recorder.before.count(lua_topointer(L, index)) != 0) {
+                    throw std::logic_error("BindingSchema can't record a table created before the registration");
+                }
+                value.type = VALUE_NODE;
+                value.index = static_cast<size_t>(RecordObject(recorder, index));
+                break;
+            case LUA_TUSERDATA:
+                if (lua_getmetatable(L, index)) {
+                    lua_pop(L, 1);
+                    throw std::logic_error("BindingSchema can't record a userdata with a metatable");
+                }
+                value.type = VALUE_NODE;
+                value.index = static_cast<size_t>(RecordObject(recorder, index));
+                break;
+            default:
+                throw std::logic_error("BindingSchema can't record a thread");
+        }
+        return value;
+    }
+
+    /**
+     * Record a table, closure or userdata once and return its node.
+     */
+    int RecordObject(Recorder &recorder, int index)
+    {
+        lua_State *L = recorder.L;
+        const void *p = lua_topointer(L, index);
+        std::unordered_map<const void *, int>::iterator it = recorder.nodes.find(p);
+        if (it != recorder.nodes.end()) {
+            return it->second;
+        }
+        lua_checkstack(L, 4);
+
+        Node node;
+        memset(&node, 0, sizeof(node));
+        node.metatable = -1;
+        int type = lua_type(L, index);
+        if (type == LUA_TUSERDATA) {
+            node.type = NODE_USERDATA;
+            node.first = m_blob.size();
+            node.count = lua_rawlen(L, index);
+            m_blob.append(static_cast<const char *>(lua_touserdata(L, index)), node.count);
+            m_nodes.push_back(node);
+            return recorder.nodes[p] = static_cast<int>(m_nodes.size() - 1);
+        }
+
+        if (type == LUA_TFUNCTION) {
+            std::vector<Value> upvalues;
+            for (int i = 1; lua_getupvalue(L, index, i) != NULL; ++i) {
+                upvalues.push_back(RecordValue(recorder, -1));
+                lua_pop(L, 1);
+            }
+            node.type = NODE_CLOSURE;
+            node.function = lua_tocfunction(L, index);
+            node.first = m_upvalues.size();
+            node.count = upvalues.size();
+            m_upvalues.insert(m_upvalues.end(), upvalues.begin(), upvalues.end());
+            m_nodes.push_back(node);
+            return recorder.nodes[p] = static_cast<int>(m_nodes.size() - 1);
+        }
+
+        // The table node exists before its fields are recorded, fields may refer back to it
+        int id = static_cast<int>(m_nodes.size());
+        recorder.nodes[p] = id;
+        node.type = NODE_TABLE;
+        m_nodes.push_back(node);
+
+        lua_Integer narr = 0;
+        while (lua_rawgeti(L, index, narr + 1) != LUA_TNIL) {
+            lua_pop(L, 1);
+            ++narr;
+        }
+        lua_pop(L, 1);
+
+        std::vector<Value> fields;
+        lua_pushnil(L);
+        while (lua_next(L, index)) {
+            fields.push_back(RecordValue(recorder, -2));
+            fields.push_back(RecordValue(recorder, -1));
+            lua_pop(L, 1);
+        }
+        int metatable = -1;
+        if (lua_getmetatable(L, index)) {
+            Value value = RecordValue(recorder, -1);
+            lua_pop(L, 1);
+            if (value.type != VALUE_NODE) {
+                throw std::logic_error("BindingSchema can't record a metatable created before the registration");
+            }
+            metatable = static_cast<int>(value.index);
+        }
+
+        Node &table = m_nodes[id];
+        table.metatable = metatable;
+        table.narr = static_cast<int>(narr);
+        table.nrec = static_cast<int>(fields.size() / 2 - narr);
+        table.first = m_fields.size() / 2;
+        table.count = fields.size() / 2;
+        m_fields.insert(m_fields.end(), fields.begin(), fields.end());
+        return id;
+    }
+
+    void Push(lua_State *L, int base, const Value &value) const
+    {
+        switch (value.type) {
+            case VALUE_BOOLEAN:
+                lua_pushboolean(L, value.boolean);
+                break;
+            case VALUE_INTEGER:
+                lua_pushinteger(L, value.integer);
+                break;
+            case VALUE_NUMBER:
+                lua_pushnumber(L, value.number);
+                break;
+            case VALUE_STRING:
+                lua_pushlstring(L, m_strings[value.index].data(), m_strings[value.index].size());
+                break;
+            case VALUE_LIGHTUSERDATA:
+                lua_pushlightuserdata(L, value.pointer);
+                break;
+            case VALUE_CFUNCTION:
+                lua_pushcfunction(L, value.function);
+                break;
+            case VALUE_GLOBALS:
+                lua_pushglobaltable(L);
+                break;
+            case VALUE_NODE:
+                lua_pushvalue(L, base + 1 + static_cast<int>(value.index));
+                break;
+            default:
+                lua_pushnil(L);
+                break;
+        }
+    }
+
+    void SetRoots(lua_State *L, int base, int index, const std::vector<Value> &roots) const
+    {
+        index = lua_absindex(L, index);
+        for (size_t i = 0; i < roots.size(); i += 2) {
+            Push(L, base, roots[i]);
+            Push(L, base, roots[i + 1]);
+            lua_rawset(L, index);
+        }
+    }
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<Value> m_fields;
+    std::vector<Value> m_upvalues;
+    std::vector<Value> m_globals;
+    std::vector<Value> m_registry;
+    std::vector<std::string> m_strings;
+    std::string m_blob;
+};
+
+} // namespace luabridge
+
+#endif
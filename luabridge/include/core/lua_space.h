@@ -33,6 +33,7 @@
 #define __LUA_NAMESPACE_H__
 
 #include "lua_class.h"
+#include "lua_enum.h"
 #include "lua_helpers.h"
 
 using namespace std;
@@ -73,6 +74,16 @@ public:
         this->m_name = other.m_name;
     }
 
+    Namespace &operator=(const Namespace &other)
+    {
+        if (&other == this) {
+            return *this;
+        }
+        this->m_pLuaVm = other.m_pLuaVm;
+        this->m_name = other.m_name;
+        return *this;
+    }
+
     /**
      * Open the global namespace for registrations.
      * 默认命名空间，lua _G表，如果没有指定命名空间则所有的操作在_G表中
@@ -185,6 +196,41 @@ public:
         CFunc::AddSetter(L, name, -2); // Stack: ns
     }
 
+    /**
+     * 在命名空间中注册一个枚举,值用AddValue添加,EndEnum后生效
+     * @tparam E enum type
+     * @param name
+     * @return
+     */
+    template<class E>
+    Enum<E> BeginEnum(char const *name)
+    {
+        m_pLuaVm->AssertIsActive();
+        return Enum<E>(name, m_pLuaVm);
+    }
+
+    /**
+     * Add or replace a constant.在命名空间中添加一个常量
+     * The value is copied into the constants table of the namespace, reads are resolved
+     * by the Lua VM without a C call and writes raise a lua error.
+     * @tparam T  number, string, bool or enum
+     * @param name
+     * @param value
+     */
+    template<class T>
+    void AddConstant(char const *name, T value)
+    {
+        lua_State *L = m_pLuaVm->LuaState();
+        if (m_pLuaVm->GetStackSize() == 1) {
+            LUA_ASSERT_EX(L, false, "AddConstant () called on global namespace", false);
+        }
+
+        LUA_ASSERT_EX (L, lua_istable(L, -1), "lua_istable(L, -1)", false); // Stack: namespace table (ns)
+
+        Stack<T>::push(L, value); // Stack: ns, value
+        CFunc::AddConstant(L, name, -2); // Stack: ns
+    }
+
     /**
      * Add or replace a variable.在命名空间中添加一个全局变量
      * @tparam TG  variable type
@@ -275,6 +321,18 @@ public:
         AddCFunction(func, LuaCFunctionWrap<__COUNTER__>(fp));
     }
 
+    /**
+     * register cfunction bound at compile time, see REGISTER_CFUNC_T
+     * @tparam FnPtr func type
+     * @tparam fn    func
+     * @param func   func name 函数名
+     **/
+    template<class FnPtr, FnPtr fn>
+    void AddCFunction(const char *func)
+    {
+        AddCFunction(func, &StaticCFunction<FnPtr, fn>::Call);
+    }
+
     /**
      * register cfunction
      * @param L    lua_State
@@ -299,6 +357,19 @@ public:
         AddGlobalCFunc(L, func, LuaCFunctionWrap<__COUNTER__>(fp));
     }
 
+    /**
+     * register global cfunction bound at compile time, see REGISTER_CFUNC_T
+     * @tparam FnPtr func type
+     * @tparam fn    func
+     * @param L      lua_State
+     * @param func   func name 函数名
+     **/
+    template<class FnPtr, FnPtr fn>
+    static void AddGlobalCFunc(lua_State *L, const char *func)
+    {
+        AddGlobalCFunc(L, func, &StaticCFunction<FnPtr, fn>::Call);
+    }
+
     //----------------------------------------------------------------------------
     /**
         Open a new or existing class for registrations.
@@ -318,10 +389,11 @@ public:
         Do not call DeriveClass () again.
     */
     template<class Derived, class Base>
-    Class<Derived> DeriveClass(char const *name)
+    Class<Derived> DeriveClass(char const *name, bool shared = false)
     {
         m_pLuaVm->AssertIsActive();
-        return Class<Derived>(name, m_pLuaVm, ClassInfo<Base>::GetStaticKey());
+        ClassInfo<Derived>::GetTypeInfo()->SetParent(ClassInfo<Base>::GetTypeInfo());
+        return Class<Derived>(name, m_pLuaVm, ClassInfo<Base>::GetStaticKey(), shared);
     }
 
     void Reset()
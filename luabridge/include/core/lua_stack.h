@@ -37,13 +37,19 @@
 #include "lua_library.h"
 #include "lua_helpers.h"
 #include "user_data.h"
+#include "type_list.h"
 #include <string>
+#include <tuple>
+#include <type_traits>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 namespace luabridge
 {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<class T>
+template<class T, class Enable>
 struct Stack;
 
 template<>
@@ -86,6 +92,24 @@ struct Stack<lua_CFunction>
 };
 
 //------------------------------------------------------------------------------
+/**
+    Stack specialization for enums, values are passed as integers.
+*/
+template<class E>
+struct Stack<E, typename std::enable_if<std::is_enum<E>::value>::type>
+{
+    static void push(lua_State *L, E value)
+    {
+        lua_pushinteger(L, static_cast <lua_Integer> (value));
+    }
+
+    static E get(lua_State *L, int index, bool luaerror = true)
+    {
+        LUA_ASSERT_EX(L, LuaHelper::CheckLuaArg_Integer(L, index), "CheckLuaArg_Integer failed", luaerror);
+        return static_cast<E>(lua_tointeger(L, index));
+    }
+};
+
 /**
     Stack specialization for `int`.
 */
@@ -414,18 +438,21 @@ struct Stack<BinaryStr>
 {
     static void push(lua_State *L, BinaryStr pStr)
     {
-        if (pStr.m_pStr != NULL && pStr.m_iLen > 0) {
-            lua_pushlstring(L, pStr.m_pStr, pStr.m_iLen);
+        if (pStr.m_pStr != NULL) {
+            lua_pushlstring(L, pStr.m_pStr, pStr.m_iLen > 0 ? pStr.m_iLen : 0);
+        }
+        else {
+            lua_pushnil(L);
         }
     }
 
-    BinaryStr get(lua_State *L, int index, bool luaerror = true)
+    static BinaryStr get(lua_State *L, int index, bool luaerror = true)
     {
         //抛出c++异常
         LUA_ASSERT_EX(L, LuaHelper::CheckLuaArg_Str(L, index), "CheckLuaArg_Str failed", luaerror);
         size_t len;
         const char *str = lua_tolstring(L, index, &len);
-        return BinaryStr(str, len);
+        return BinaryStr(str, static_cast<int>(len));
     }
 };
 //------------------------------------------------------------------------------
@@ -467,6 +494,131 @@ struct Stack<std::string>
     }
 };
 
+//------------------------------------------------------------------------------
+/**
+    Stack specialization for `StringView`.
+    get borrows the Lua string buffer without allocating, the view is valid
+    while the value stays on the stack (for the duration of a bound call).
+*/
+template<>
+struct Stack<StringView>
+{
+    static void push(lua_State *L, StringView const &str)
+    {
+        lua_pushlstring(L, str.data(), str.size());
+    }
+
+    static StringView get(lua_State *L, int index, bool luaerror = true)
+    {
+        LUA_ASSERT_EX(L, LuaHelper::CheckLuaArg_Str(L, index), "CheckLuaArg_Str failed", luaerror);
+        if (lua_isnil(L, index)) {
+            return StringView();
+        }
+        size_t len;
+        const char *str = lua_tolstring(L, index, &len);
+        return StringView(str, len);
+    }
+};
+
+#if __cplusplus >= 201703L
+//------------------------------------------------------------------------------
+/**
+    Stack specialization for `std::string_view`, same lifetime rules as StringView.
+*/
+template<>
+struct Stack<std::string_view>
+{
+    static void push(lua_State *L, std::string_view str)
+    {
+        lua_pushlstring(L, str.data(), str.size());
+    }
+
+    static std::string_view get(lua_State *L, int index, bool luaerror = true)
+    {
+        LUA_ASSERT_EX(L, LuaHelper::CheckLuaArg_Str(L, index), "CheckLuaArg_Str failed", luaerror);
+        if (lua_isnil(L, index)) {
+            return std::string_view();
+        }
+        size_t len;
+        const char *str = lua_tolstring(L, index, &len);
+        return std::string_view(str, len);
+    }
+};
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    Whether T is a std::tuple, after removing references and cv qualifiers.
+*/
+template<class T>
+struct IsTuple
+{
+    static const bool value = false;
+};
+
+template<class... Ts>
+struct IsTuple<std::tuple<Ts...> >
+{
+    static const bool value = true;
+};
+
+template<class T>
+struct StackCountOf
+{
+    static const int value = 1;
+};
+
+template<class... Ts>
+struct StackCountOf<std::tuple<Ts...> >
+{
+    static const int value = sizeof...(Ts);
+};
+
+/**
+    Number of lua stack slots a value occupies, more than one for std::tuple
+    which is pushed and read as lua multiple values. T is decayed, a function
+    returning std::tuple<...> const & pushes as many values as one returning
+    the tuple by value.
+*/
+template<class T>
+struct StackCount: StackCountOf<typename std::decay<T>::type>
+{
+};
+
+//------------------------------------------------------------------------------
+/**
+    Stack specialization for `std::tuple`.
+    push pushes every element as a separate value (lua multiple returns, no
+    table), get reads sizeof...(Ts) consecutive values starting at index.
+*/
+template<class... Ts>
+struct Stack<std::tuple<Ts...> >
+{
+    static void push(lua_State *L, std::tuple<Ts...> const &t)
+    {
+        push(L, t, typename MakeIndexSequence<sizeof...(Ts)>::Type());
+    }
+
+    static std::tuple<Ts...> get(lua_State *L, int index, bool luaerror = true)
+    {
+        return get(L, lua_absindex(L, index), luaerror, typename MakeIndexSequence<sizeof...(Ts)>::Type());
+    }
+
+private:
+    template<size_t... I>
+    static void push(lua_State *L, std::tuple<Ts...> const &t, IndexSequence<I...>)
+    {
+        int dummy[] = {0, (Stack<Ts>::push(L, std::get<I>(t)), 0)...};
+        (void) dummy;
+    }
+
+    template<size_t... I>
+    static std::tuple<Ts...> get(lua_State *L, int index, bool luaerror, IndexSequence<I...>)
+    {
+        return std::tuple<Ts...>(Stack<Ts>::get(L, index + static_cast<int>(I), luaerror)...);
+    }
+};
+
 template<class T>
 struct StackOpSelector<T &, false>
 {
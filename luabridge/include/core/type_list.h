@@ -236,6 +236,26 @@ struct ArgTypeList
 //获取指定函数参数指定位置的参数类型
 #define  LUA_PARAM_TYPE(n) typename ArgTypeList<ParamList...>::template args<n>::type
 
+/**
+  Compile-time sequence of indices, the C++11 counterpart of std::index_sequence.
+  MakeIndexSequence<N>::Type is IndexSequence<0, 1, ..., N - 1>.
+*/
+template<size_t... I>
+struct IndexSequence
+{
+};
+
+template<size_t N, size_t... I>
+struct MakeIndexSequence: MakeIndexSequence<N - 1, N - 1, I...>
+{
+};
+
+template<size_t... I>
+struct MakeIndexSequence<0, I...>
+{
+    typedef IndexSequence<I...> Type;
+};
+
 } // namespace luabridge
 
 #endif
\ No newline at end of file
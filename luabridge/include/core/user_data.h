@@ -37,6 +37,9 @@
 #include "lua_helpers.h"
 #include <cassert>
 #include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
 
 
 namespace luabridge
@@ -62,7 +65,27 @@ namespace luabridge
 class Userdata
 {
 protected:
+    /**
+      How the object is held, decides what __gc has to do.
+    */
+    enum
+    {
+        STORAGE_PTR = 0, // pointer to an object owned by C++, nothing to destroy
+        STORAGE_VALUE = 1, // object constructed inside the userdata (UserdataValue)
+        STORAGE_SHARED = 2 // container inside the userdata (UserdataShared)
+    };
+
     void *m_p; // subclasses must set this
+    void const *m_magic; // identifies a userdata created by LuaBridge
+    ClassTypeInfo const *m_type; // class of the object, null if unknown
+    bool m_const; // pushed with the const table
+    unsigned char m_kind; // STORAGE_PTR, STORAGE_VALUE or STORAGE_SHARED
+    bool m_counted; // counted in the class stats, undone by __gc
+
+    Userdata()
+        : m_p(0), m_magic(GetMagic()), m_type(0), m_const(false), m_kind(STORAGE_PTR), m_counted(false)
+    {
+    }
 
     //--------------------------------------------------------------------------
     /**
@@ -74,6 +97,39 @@ protected:
     }
 
 private:
+    /**
+      Unique value stored in the header of every LuaBridge userdata.
+    */
+    static void const *GetMagic()
+    {
+        static char value;
+        return &value;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Retrieve a Userdata on the stack using the type recorded in its header.
+
+      Handles the exact-match and derived-match cases with pointer compares and
+      no Lua stack traffic. Returns null when the value is not a LuaBridge
+      userdata of a known class, or the check fails, so that getClass can do
+      the full validation and report the error.
+    */
+    static Userdata *FastGetClass(lua_State *L, int index, ClassTypeInfo const *type, bool canBeConst)
+    {
+        if (lua_type(L, index) != LUA_TUSERDATA || lua_rawlen(L, index) < sizeof(Userdata)) {
+            return 0;
+        }
+        Userdata *const ud = static_cast <Userdata *> (lua_touserdata(L, index));
+        if (ud->m_magic != GetMagic() || ud->m_type == 0) {
+            return 0;
+        }
+        if (ud->m_const && !canBeConst) {
+            return 0;
+        }
+        return ud->m_type->IsA(type) ? ud : 0;
+    }
+
     //--------------------------------------------------------------------------
     /**
       Validate and retrieve a Userdata on the stack.
@@ -186,8 +242,163 @@ private:
     }
 
 public:
-    virtual ~Userdata()
-    {}
+    //--------------------------------------------------------------------------
+    /**
+      Push the metatable for key, or the cached userdata of p if the class has
+      an identity cache holding one.
+
+      Returns true if the cached userdata was pushed. Otherwise the metatable is
+      on top and the caller creates the userdata and calls SetMetatable.
+    */
+    static bool PushCachedOrMetatable(lua_State *L, void const *key, void const *p)
+    {
+        lua_rawgetp(L, LUA_REGISTRYINDEX, key); // Stack: mt
+        if (!lua_istable(L, -1)) {
+            lua_pop(L, 1);
+            throw std::logic_error("The class is not registered in LuaBridge");
+        }
+        lua_rawgetp(L, -1, GetIdentityCacheKey()); // Stack: mt, cache | nil
+        if (!lua_istable(L, -1)) {
+            lua_pop(L, 1); // Stack: mt
+            return false;
+        }
+        lua_rawgetp(L, -1, p); // Stack: mt, cache, ud | nil
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 2); // Stack: mt
+            return false;
+        }
+        lua_replace(L, -3); // Stack: ud, cache
+        lua_pop(L, 1); // Stack: ud
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Set the metatable of a new userdata and add it to the identity cache.
+    */
+    static void SetMetatable(lua_State *L, void const *p)
+    {
+        lua_insert(L, -2); // Stack: ud, mt
+        lua_rawgetp(L, -1, GetIdentityCacheKey()); // Stack: ud, mt, cache | nil
+        if (lua_istable(L, -1)) {
+            lua_pushvalue(L, -3); // Stack: ud, mt, cache, ud
+            lua_rawsetp(L, -2, p); // Stack: ud, mt, cache
+        }
+        lua_pop(L, 1); // Stack: ud, mt
+        lua_setmetatable(L, -2); // Stack: ud
+    }
+
+private:
+    /**
+      Clear p from the identity cache of the metatable registered at key and
+      of all its base class metatables, the object may have been pushed as a
+      pointer to a base class.
+    */
+    static void InvalidateCached(lua_State *L, void const *key, void const *p)
+    {
+        lua_rawgetp(L, LUA_REGISTRYINDEX, key); // Stack: mt | nil
+        while (lua_istable(L, -1)) {
+            lua_rawgetp(L, -1, GetIdentityCacheKey()); // Stack: mt, cache | nil
+            if (lua_istable(L, -1)) {
+                lua_rawgetp(L, -1, p); // Stack: mt, cache, ud | nil
+                if (lua_isuserdata(L, -1)) {
+                    static_cast<Userdata *>(lua_touserdata(L, -1))->m_p = 0;
+                }
+                lua_pop(L, 1); // Stack: mt, cache
+                lua_pushnil(L);
+                lua_rawsetp(L, -2, p); // Stack: mt, cache
+            }
+            lua_pop(L, 1); // Stack: mt
+            lua_rawgetp(L, -1, GetParentKey()); // Stack: mt, parent mt | nil
+            lua_remove(L, -2); // Stack: parent mt | nil
+        }
+        lua_pop(L, 1); // Stack: -
+    }
+
+public:
+    //--------------------------------------------------------------------------
+    /**
+      __gc metamethod for the class metatables of T.
+
+      Userdata has no vtable, the storage kind recorded in the header selects
+      the cleanup. Classes whose userdata never need cleanup (trivially
+      destructible T, not shared) get no __gc at all, see NeedsGcMetaMethod.
+    */
+    template<class T>
+    static int GCMetaMethod(lua_State *L);
+
+    /**
+      Whether the class metatables of T need a __gc metamethod at registration.
+
+      Without __gc, UserdataPtr and UserdataValue of trivially destructible T
+      are not put on the Lua finalizer list and are freed as plain memory.
+      Shared classes hold containers that always need their destructor run.
+    */
+    template<class T>
+    static bool NeedsGcMetaMethod(bool shared)
+    {
+        return shared || !std::is_trivially_destructible<T>::value;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Install the __gc metamethod in the metatable on top of the stack if it
+      has none, used before a container is pushed for a class that was
+      registered without __gc.
+    */
+    template<class T>
+    static void EnsureGcMetaMethod(lua_State *L)
+    {
+        lua_pushliteral(L, "__gc"); // Stack: mt, "__gc"
+        lua_rawget(L, -2); // Stack: mt, gc | nil
+        bool hasGc = !lua_isnil(L, -1);
+        lua_pop(L, 1); // Stack: mt
+        if (!hasGc) {
+            lua_pushcfunction(L, &Userdata::GCMetaMethod<T>); // Stack: mt, gc
+            LuaHelper::RawSetField(L, -2, "__gc"); // Stack: mt
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Drop the cached userdata of p from the identity caches of T and of its
+      base classes.
+
+      Call this when C++ destroys an object of a class using the identity
+      cache. A script still holding the userdata gets an error on use instead
+      of touching freed memory.
+    */
+    template<class T>
+    static void Invalidate(lua_State *L, T const *p)
+    {
+        InvalidateCached(L, ClassInfo<T>::GetClassKey(), p);
+        InvalidateCached(L, ClassInfo<T>::GetConstKey(), p);
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Record the class of the object, used by the fast type check.
+
+      isConst must be true if the userdata gets the const table as metatable.
+    */
+    void SetType(ClassTypeInfo const *type, bool isConst)
+    {
+        m_type = type;
+        m_const = isConst;
+    }
+
+    //--------------------------------------------------------------------------
+    /**
+      Count a new userdata of bytes size in the stats of its class, if the
+      class has stats enabled. Called after SetType.
+    */
+    void Created(size_t bytes)
+    {
+        if (m_type != 0 && m_type->IsTracked()) {
+            m_counted = true;
+            m_type->OnCreate(bytes);
+        }
+    }
 
     //--------------------------------------------------------------------------
     /**
@@ -214,10 +425,13 @@ public:
         if (lua_isnil(L, index))
             return 0;
 
-        return static_cast <T *> (getClass(
-            L, index, ClassInfo<T>::GetConstKey(),
-            ClassInfo<T>::GetClassKey(),
-            canBeConst)->getPointer());
+        Userdata *ud = FastGetClass(L, index, ClassInfo<T>::GetTypeInfo(), canBeConst);
+        if (ud == 0) {
+            ud = getClass(L, index, ClassInfo<T>::GetConstKey(), ClassInfo<T>::GetClassKey(), canBeConst);
+        }
+        // Only an invalidated object has no pointer
+        LUA_ASSERT_EX(L, ud->getPointer() != 0, "object has been destroyed", luaerror);
+        return static_cast <T *> (ud->getPointer());
     }
 };
 
@@ -235,22 +449,37 @@ private:
     UserdataValue<T>(UserdataValue<T> const &);
     UserdataValue<T> operator=(UserdataValue<T> const &);
 
-    char m_storage[sizeof(T)];
+    /**
+      lua_newuserdata only guarantees the alignment of L_Umaxalign (see
+      llimits.h). Storage is aligned for T up to that, an over-aligned T
+      (SIMD types) gets alignof (T) - StorageAlign spare bytes and is placed
+      at the first suitably aligned address inside the storage.
+    */
+    union MaxAlign
+    {
+        lua_Number n;
+        double u;
+        void *s;
+        lua_Integer i;
+        long l;
+    };
+
+    static const size_t StorageAlign = alignof(T) < alignof(MaxAlign) ? alignof(T) : alignof(MaxAlign);
+    static const size_t StoragePad = alignof(T) - StorageAlign;
+
+    alignas(StorageAlign) char m_storage[sizeof(T) + StoragePad];
 
 private:
     /**
       Used for placement construction.
+      The object is destroyed by Userdata::GCMetaMethod.
     */
     UserdataValue()
     {
         m_p = 0;
-    }
-
-    ~UserdataValue()
-    {
-        if (getPointer() != 0) {
-            getObject()->~T();
-        }
+        m_kind = STORAGE_VALUE;
+        SetType(ClassInfo<T>::GetTypeInfo(), false);
+        Created(sizeof(UserdataValue<T>));
     }
 
 public:
@@ -281,6 +510,17 @@ public:
         ud->commit();
     }
 
+    /**
+      Push T via move construction, used for temporaries such as the return
+      value of a bound function so no deep copy is made.
+    */
+    static inline void push(lua_State *const L, T &&t)
+    {
+        UserdataValue<T> *ud = Place(L);
+        new(ud->getObject()) T(std::move(t));
+        ud->commit();
+    }
+
     /**
       Confirm object construction.
     */
@@ -294,7 +534,11 @@ public:
         // If this fails to compile it means you forgot to provide
         // a Container specialization for your container!
         //
-        return reinterpret_cast <T *> (&m_storage[0]);
+        if (StoragePad == 0) {
+            return reinterpret_cast <T *> (&m_storage[0]);
+        }
+        uintptr_t p = reinterpret_cast <uintptr_t> (&m_storage[0]);
+        return reinterpret_cast <T *> ((p + alignof(T) - 1) & ~static_cast <uintptr_t> (alignof(T) - 1));
     }
 };
 
@@ -313,14 +557,15 @@ private:
 private:
     /** Push a pointer to object using metatable key.
     */
-    static void push(lua_State *L, const void *p, void const *const key)
+    static void push(lua_State *L, const void *p, void const *const key, ClassTypeInfo const *type, bool isConst)
     {
-        new(lua_newuserdata(L, sizeof(UserdataPtr))) UserdataPtr(const_cast <void *> (p));
-        lua_rawgetp(L, LUA_REGISTRYINDEX, key);
-        if (!lua_istable(L, -1)) {
-            throw std::logic_error("The class is not registered in LuaBridge");
+        if (PushCachedOrMetatable(L, key, p)) {
+            return;
         }
-        lua_setmetatable(L, -2);
+        UserdataPtr *const ud = new(lua_newuserdata(L, sizeof(UserdataPtr))) UserdataPtr(const_cast <void *> (p));
+        ud->SetType(type, isConst);
+        ud->Created(sizeof(UserdataPtr));
+        SetMetatable(L, p);
     }
 
     explicit UserdataPtr(void *const p)
@@ -339,7 +584,7 @@ public:
     static void push(lua_State *const L, T *const p)
     {
         if (p)
-            push(L, p, ClassInfo<T>::GetClassKey());
+            push(L, p, ClassInfo<T>::GetClassKey(), ClassInfo<T>::GetTypeInfo(), false);
         else
             lua_pushnil(L);
     }
@@ -350,12 +595,38 @@ public:
     static void push(lua_State *const L, T const *const p)
     {
         if (p)
-            push(L, p, ClassInfo<T>::GetConstKey());
+            push(L, p, ClassInfo<T>::GetConstKey(), ClassInfo<T>::GetTypeInfo(), true);
         else
             lua_pushnil(L);
     }
 };
 
+//============================================================================
+/**
+  Common part of UserdataShared, lets __gc destroy the container without
+  knowing its type.
+*/
+class UserdataSharedBase: public Userdata
+{
+protected:
+    typedef void (*DestroyFn)(UserdataSharedBase *);
+
+    explicit UserdataSharedBase(DestroyFn destroy)
+        : m_destroy(destroy)
+    {
+        m_kind = STORAGE_SHARED;
+    }
+
+public:
+    void Destroy()
+    {
+        m_destroy(this);
+    }
+
+private:
+    DestroyFn m_destroy;
+};
+
 //============================================================================
 /**
   Wraps a container that references a class object.
@@ -364,7 +635,7 @@ public:
   specialized on C or else a compile error will result.
 */
 template<class C>
-class UserdataShared: public Userdata
+class UserdataShared: public UserdataSharedBase
 {
 private:
     UserdataShared(UserdataShared<C> const &);
@@ -381,13 +652,18 @@ private:
         //printf("~UserdataShared()\n");
     }
 
+    static void DestroyContainer(UserdataSharedBase *ud)
+    {
+        static_cast<UserdataShared<C> *>(ud)->~UserdataShared<C>();
+    }
+
 public:
     /**
       Construct from a container to the class or a derived class.
     */
     template<class U>
     explicit UserdataShared(U const &u)
-        : m_c(u)
+        : UserdataSharedBase(&UserdataShared<C>::DestroyContainer), m_c(u)
     {
         m_p = const_cast <void *> (reinterpret_cast <void const *> (
             (ContainerTraits<C>::get(m_c))));
@@ -398,13 +674,31 @@ public:
     */
     template<class U>
     explicit UserdataShared(U *u)
-        : m_c(u)
+        : UserdataSharedBase(&UserdataShared<C>::DestroyContainer), m_c(u)
     {
         m_p = const_cast <void *> (reinterpret_cast <void const *> (
             (ContainerTraits<C>::get(m_c))));
     }
 };
 
+template<class T>
+inline int Userdata::GCMetaMethod(lua_State *L)
+{
+    Userdata *const ud = static_cast <Userdata *> (lua_touserdata(L, 1));
+    if (ud->m_counted) {
+        ud->m_type->OnDestroy(lua_rawlen(L, 1));
+    }
+    if (ud->m_kind == STORAGE_VALUE) {
+        if (ud->m_p != 0) {
+            static_cast <T *> (ud->m_p)->~T();
+        }
+    }
+    else if (ud->m_kind == STORAGE_SHARED) {
+        static_cast <UserdataSharedBase *> (ud)->Destroy();
+    }
+    return 0;
+}
+
 //----------------------------------------------------------------------------
 //
 // SFINAE helpers.
@@ -419,12 +713,16 @@ struct UserdataSharedHelper
 
     static void push(lua_State *L, C const &c)
     {
-        if (ContainerTraits<C>::get(c) != 0) {
-            new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(c);
-            lua_rawgetp(L, LUA_REGISTRYINDEX, ClassInfo<T>::GetClassKey());
-            // If this goes off it means the class T is unregistered!
-            LUA_ASSERT(L, lua_istable(L, -1), "UserdataSharedHelper::push<C&> lua_istable failed");
-            lua_setmetatable(L, -2);
+        void const *p = ContainerTraits<C>::get(c);
+        if (p != 0) {
+            if (Userdata::PushCachedOrMetatable(L, ClassInfo<T>::GetClassKey(), p)) {
+                return;
+            }
+            Userdata::EnsureGcMetaMethod<T>(L);
+            UserdataShared<C> *const ud = new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(c);
+            ud->SetType(ClassInfo<T>::GetTypeInfo(), false);
+            ud->Created(sizeof(UserdataShared<C>));
+            Userdata::SetMetatable(L, p);
         }
         else {
             lua_pushnil(L);
@@ -434,11 +732,14 @@ struct UserdataSharedHelper
     static void push(lua_State *L, T *const t)
     {
         if (t) {
-            new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(t);
-            lua_rawgetp(L, LUA_REGISTRYINDEX, ClassInfo<T>::GetClassKey());
-            // If this goes off it means the class T is unregistered!
-            LUA_ASSERT(L, lua_istable(L, -1), "UserdataSharedHelper::push<T*> lua_istable failed");
-            lua_setmetatable(L, -2);
+            if (Userdata::PushCachedOrMetatable(L, ClassInfo<T>::GetClassKey(), t)) {
+                return;
+            }
+            Userdata::EnsureGcMetaMethod<T>(L);
+            UserdataShared<C> *const ud = new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(t);
+            ud->SetType(ClassInfo<T>::GetTypeInfo(), false);
+            ud->Created(sizeof(UserdataShared<C>));
+            Userdata::SetMetatable(L, t);
         }
         else {
             lua_pushnil(L);
@@ -455,12 +756,16 @@ struct UserdataSharedHelper<C, true>
 
     static void push(lua_State *L, C const &c)
     {
-        if (ContainerTraits<C>::get(c) != 0) {
-            new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(c);
-            lua_rawgetp(L, LUA_REGISTRYINDEX, ClassInfo<T>::GetConstKey());
-            // If this goes off it means the class T is unregistered!
-            assert (lua_istable(L, -1));
-            lua_setmetatable(L, -2);
+        void const *p = ContainerTraits<C>::get(c);
+        if (p != 0) {
+            if (Userdata::PushCachedOrMetatable(L, ClassInfo<T>::GetConstKey(), p)) {
+                return;
+            }
+            Userdata::EnsureGcMetaMethod<T>(L);
+            UserdataShared<C> *const ud = new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(c);
+            ud->SetType(ClassInfo<T>::GetTypeInfo(), true);
+            ud->Created(sizeof(UserdataShared<C>));
+            Userdata::SetMetatable(L, p);
         }
         else {
             lua_pushnil(L);
@@ -470,11 +775,14 @@ struct UserdataSharedHelper<C, true>
     static void push(lua_State *L, T *const t)
     {
         if (t) {
-            new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(t);
-            lua_rawgetp(L, LUA_REGISTRYINDEX, ClassInfo<T>::GetConstKey());
-            // If this goes off it means the class T is unregistered!
-            assert (lua_istable(L, -1));
-            lua_setmetatable(L, -2);
+            if (Userdata::PushCachedOrMetatable(L, ClassInfo<T>::GetConstKey(), t)) {
+                return;
+            }
+            Userdata::EnsureGcMetaMethod<T>(L);
+            UserdataShared<C> *const ud = new(lua_newuserdata(L, sizeof(UserdataShared<C>))) UserdataShared<C>(t);
+            ud->SetType(ClassInfo<T>::GetTypeInfo(), true);
+            ud->Created(sizeof(UserdataShared<C>));
+            Userdata::SetMetatable(L, t);
         }
         else {
             lua_pushnil(L);
@@ -503,9 +811,9 @@ struct StackHelper
     typedef typename TypeTraits::removeConst<
         typename ContainerTraits<C>::Type>::Type T;
 
-    static C get(lua_State *L, int index)
+    static C get(lua_State *L, int index, bool luaerror = true)
     {
-        return Userdata::get<T>(L, index, true);
+        return Userdata::get<T>(L, index, true, luaerror);
     }
 };
 
@@ -524,9 +832,14 @@ struct StackHelper<T, false>
         UserdataValue<T>::push(L, t);
     }
 
-    static inline T const &get(lua_State *L, int index)
+    static inline void push(lua_State *L, T &&t)
     {
-        return *Userdata::get<T>(L, index, true);
+        UserdataValue<T>::push(L, std::move(t));
+    }
+
+    static inline T const &get(lua_State *L, int index, bool luaerror = true)
+    {
+        return *Userdata::get<T>(L, index, true, luaerror);
     }
 };
 
@@ -554,9 +867,9 @@ struct RefStackHelper
     typedef typename TypeTraits::removeConst<
         typename ContainerTraits<C>::Type>::Type T;
 
-    static return_type get(lua_State *L, int index)
+    static return_type get(lua_State *L, int index, bool luaerror = true)
     {
-        return Userdata::get<T>(L, index, true);
+        return Userdata::get<T>(L, index, true, luaerror);
     }
 };
 
@@ -570,9 +883,9 @@ struct RefStackHelper<T, false>
         UserdataPtr::push(L, &t);
     }
 
-    static return_type get(lua_State *L, int index)
+    static return_type get(lua_State *L, int index, bool luaerror = true)
     {
-        T *t = Userdata::get<T>(L, index, true);
+        T *t = Userdata::get<T>(L, index, true, luaerror);
 
         if (!t)
             luaL_error(L, "nil passed to reference");
@@ -601,9 +914,9 @@ struct UserdataGetter
 {
     typedef T *ReturnType;
 
-    static ReturnType get(lua_State *L, int index)
+    static ReturnType get(lua_State *L, int index, bool luaerror = true)
     {
-        return Userdata::get<T>(L, index, false);
+        return Userdata::get<T>(L, index, false, luaerror);
     }
 };
 
@@ -612,9 +925,9 @@ struct UserdataGetter<T, typename Void<T (*)()>::Type>
 {
     typedef T ReturnType;
 
-    static ReturnType get(lua_State *L, int index)
+    static ReturnType get(lua_State *L, int index, bool luaerror = true)
     {
-        return StackHelper<T, TypeTraits::isContainer<T>::value>::get(L, index);
+        return StackHelper<T, TypeTraits::isContainer<T>::value>::get(L, index, luaerror);
     }
 };
 
@@ -622,8 +935,11 @@ struct UserdataGetter<T, typename Void<T (*)()>::Type>
 
 /**
   Lua stack conversions for class objects passed by value.
+
+  Enable is void, it lets other types (enums) be selected by partial
+  specialization.
 */
-template<class T>
+template<class T, class Enable = void>
 struct Stack
 {
     typedef void IsUserdata;
@@ -636,9 +952,14 @@ struct Stack
         StackHelper<T, TypeTraits::isContainer<T>::value>::push(L, value);
     }
 
-    static ReturnType get(lua_State *L, int index)
+    static void push(lua_State *L, T &&value)
+    {
+        StackHelper<T, TypeTraits::isContainer<T>::value>::push(L, std::move(value));
+    }
+
+    static ReturnType get(lua_State *L, int index, bool luaerror = true)
     {
-        return Getter::get(L, index);
+        return Getter::get(L, index, luaerror);
     }
 };
 
@@ -34,6 +34,7 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 #include <memory>
 #include "lua_file.h"
 
@@ -52,6 +53,19 @@ public:
      */
     LuaBridge(lua_State *VM);
 
+    /**
+     * Construct with a custom allocator
+     * @param allocFn lua_Alloc function
+     * @param ud      user data passed to allocFn
+     */
+    LuaBridge(lua_Alloc allocFn, void *ud);
+
+    /**
+     * Construct with the size class pool allocator, pool must outlive the LuaBridge
+     * @param pool
+     */
+    explicit LuaBridge(LuaPoolAllocator &pool);
+
     /**
      * destruct
      */
@@ -66,6 +80,41 @@ public:
 
     bool LoadFile(const char *filePath);
 
+    /**
+     * Load scripts through the bytecode cache, NULL loads from source
+     * @param cache  must outlive the LuaBridge or be reset before destroyed
+     */
+    void SetBytecodeCache(BytecodeCache *cache);
+
+    /**
+     * 先在threads个线程中并行编译所有脚本,再按顺序加载执行
+     * Uses the bytecode cache if one is set, otherwise a temporary one.
+     * @param filePaths
+     * @param threads   0 uses std::thread::hardware_concurrency ()
+     * @return true, a script error throws like LoadFile
+     */
+    bool LoadFiles(const std::vector<std::string> &filePaths, unsigned int threads = 0);
+
+    /**
+     * require的模块先在脚本包中查找,bundle must stay open while the LuaBridge is alive
+     * @param bundle
+     */
+    void AddScriptBundle(const ScriptBundle &bundle);
+
+    /**
+     * 在一个临时的lua_State中执行注册函数,把注册结果记录到schema
+     * The schema can then be replayed into any number of LuaBridge with ReplaySchema.
+     * @param schema
+     * @param registration  does the usual BEGIN_CLASS/CLASS_ADD_... registration on its argument
+     */
+    static void RecordSchema(BindingSchema &schema, const std::function<void(LuaBridge &)> &registration);
+
+    /**
+     * 回放记录的绑定,不再执行注册代码
+     * @param schema
+     */
+    void ReplaySchema(const BindingSchema &schema);
+
     /**
      * Call Lua function
      * @tparam R    返回类型
@@ -77,6 +126,35 @@ public:
      */
     template<typename R, typename ...Args>
     R CallLuaFunc(const char *func, const Args... args);
+
+    /**
+     * 对区间[begin, end)的每个元素调用lua函数func(element),所有调用在一次lua_pcall中完成
+     * 类对象按引用传入lua,出错时停止并打印错误
+     * @param func  函数名
+     * @return 是否全部调用成功
+     * Sample:	lua.CallForEach("on_entity_tick", entities.begin(), entities.end());
+     */
+    template<typename Iter>
+    bool CallForEach(const char *func, Iter begin, Iter end);
+
+    /**
+     * 把区间[begin, end)作为一个类数组的userdata调用lua函数func(range),lua中用range[i], #range遍历
+     * range只在本次调用中有效
+     * @param func  函数名
+     * @return 是否调用成功
+     * Sample:	lua.CallWithRange("on_tick_all", entities.begin(), entities.end());
+     */
+    template<typename Iter>
+    bool CallWithRange(const char *func, Iter begin, Iter end);
+
+    /**
+     * 获取预先解析的lua函数句柄,用于高频调用
+     * @tparam FT   函数类型 R(Args...)
+     * @param func  函数名
+     * Sample:	LuaFunction<void(int)> onTick = lua.GetLuaFunction<void(int)>("on_tick"); onTick(1);
+     */
+    template<typename FT>
+    LuaFunction<FT> GetLuaFunction(const char *func);
     /**
      *
      * @param func 函数名
@@ -98,6 +176,13 @@ public:
      */
     template<class T>
     static int PushSharedObjToLua(lua_State *L, std::shared_ptr<T> ptr);
+    /**
+     * 注册全局函数name,lua中调用返回开启了统计(EnableStats)的类的对象个数快照
+     * { [类名] = { live = 存活个数, created = 创建总数, bytes = 存活userdata字节数 } }
+     * @param name 函数名
+     */
+    void RegisterClassStats(const char *name = "ClassStats");
+
     /**
      * @return _G TABLE
      */
@@ -149,11 +234,13 @@ private:
 private:
     LuaVm *m_pLuaVm;
     Namespace m_namespace;
+    Namespace m_globalNamespace;
+    BytecodeCache *m_pBytecodeCache;
     int m_iTopIndex;
 };
 
 LuaBridge::LuaBridge()
-    : m_iTopIndex(0)
+    : m_pBytecodeCache(NULL), m_iTopIndex(0)
 {
     lua_State *pState = luaL_newstate();
     if (pState == NULL) {
@@ -166,7 +253,7 @@ LuaBridge::LuaBridge()
 }
 
 LuaBridge::LuaBridge(lua_State *VM)
-    : m_iTopIndex(0)
+    : m_pBytecodeCache(NULL), m_iTopIndex(0)
 {
     if (VM == NULL) {
         throw std::runtime_error("LuaBridge constructor failed");
@@ -178,9 +265,38 @@ LuaBridge::LuaBridge(lua_State *VM)
     LuaException::EnableExceptions(m_pLuaVm->LuaState());
 }
 
+LuaBridge::LuaBridge(lua_Alloc allocFn, void *ud)
+    : m_pBytecodeCache(NULL), m_iTopIndex(0)
+{
+    lua_State *pState = lua_newstate(allocFn, ud);
+    if (pState == NULL) {
+        throw std::runtime_error("LuaBridge constructor lua_newstate() failed");
+    }
+    m_pLuaVm = new LuaVm(pState);
+    // initialize lua standard library functions
+    InitLuaLibrary();
+    LuaException::EnableExceptions(m_pLuaVm->LuaState());
+}
+
+LuaBridge::LuaBridge(LuaPoolAllocator &pool)
+    : m_pBytecodeCache(NULL), m_iTopIndex(0)
+{
+    lua_State *pState = lua_newstate(&LuaPoolAllocator::Alloc, &pool);
+    if (pState == NULL) {
+        throw std::runtime_error("LuaBridge constructor lua_newstate() failed");
+    }
+    m_pLuaVm = new LuaVm(pState);
+    // initialize lua standard library functions
+    InitLuaLibrary();
+    LuaException::EnableExceptions(m_pLuaVm->LuaState());
+}
+
 LuaBridge::~LuaBridge()
 {
     lua_State *L = m_pLuaVm->LuaState();
+    // ~LuaVm pops what an unfinished registration left, L must still be open
+    delete m_pLuaVm;
+    m_pLuaVm = NULL;
     if (NULL != L) {
         lua_close(L);
     }
@@ -188,24 +304,68 @@ LuaBridge::~LuaBridge()
 
 bool LuaBridge::LoadFile(const std::string &filePath)
 {
-    lua_State *L = m_pLuaVm->LuaState();
-    int ret = luaL_dofile(L, filePath.c_str());
-    if (ret != 0) {
-        throw std::runtime_error("Lua loadfile:" + filePath + " failed, error:" + lua_tostring(L, -1));
-    }
-    return 0;
+    return LoadFile(filePath.c_str());
 }
 
 bool LuaBridge::LoadFile(const char *filePath)
 {
     lua_State *L = m_pLuaVm->LuaState();
-    int ret = luaL_dofile(L, filePath);
+    int ret = 0;
+    if (m_pBytecodeCache != NULL) {
+        ret = m_pBytecodeCache->Load(L, filePath) || lua_pcall(L, 0, LUA_MULTRET, 0);
+    }
+    else {
+        ret = luaL_dofile(L, filePath);
+    }
     if (ret != 0) {
         throw std::runtime_error("Lua loadfile:" + std::string(filePath) + " failed, error:" + lua_tostring(L, -1));
     }
     return 0;
 }
 
+void LuaBridge::SetBytecodeCache(BytecodeCache *cache)
+{
+    m_pBytecodeCache = cache;
+}
+
+bool LuaBridge::LoadFiles(const std::vector<std::string> &filePaths, unsigned int threads)
+{
+    BytecodeCache temp;
+    BytecodeCache *saved = m_pBytecodeCache;
+    if (m_pBytecodeCache == NULL) {
+        m_pBytecodeCache = &temp;
+    }
+    try {
+        m_pBytecodeCache->Precompile(filePaths, threads);
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            LoadFile(filePaths[i]);
+        }
+    }
+    catch (...) {
+        m_pBytecodeCache = saved;
+        throw;
+    }
+    m_pBytecodeCache = saved;
+    return true;
+}
+
+void LuaBridge::AddScriptBundle(const ScriptBundle &bundle)
+{
+    LUA_ASSERT_EX(m_pLuaVm->LuaState(), bundle.IsOpen(), "AddScriptBundle bundle is not open", false);
+    bundle.Install(m_pLuaVm->LuaState());
+}
+
+void LuaBridge::RecordSchema(BindingSchema &schema, const std::function<void(LuaBridge &)> &registration)
+{
+    LuaBridge luaBridge;
+    schema.Record(luaBridge.LuaState(), [&]() { registration(luaBridge); });
+}
+
+void LuaBridge::ReplaySchema(const BindingSchema &schema)
+{
+    schema.Replay(m_pLuaVm->LuaState());
+}
+
 void LuaBridge::InitLuaLibrary()
 {
     lua_State *L = m_pLuaVm->LuaState();
@@ -252,15 +412,16 @@ template<typename R, int __>
 R LuaBridge::SafeEndCall(const char *func, int nArg)
 {
     lua_State *L = m_pLuaVm->LuaState();
-    if (lua_pcall(L, nArg, 1, 0) != LUA_OK) {
+    //std::tuple返回多个值
+    if (lua_pcall(L, nArg, StackCount<R>::value, 0) != LUA_OK) {
         LuaHelper::DebugCallFuncErrorStack(L, func, lua_tostring(L, -1));
         //恢复调用前的堆栈索引
         lua_settop(L, m_iTopIndex);
-        return 0;
+        return R();
     }
     else {
         try {
-            R r = Stack<R>::get(L, -1, false);
+            R r = Stack<R>::get(L, -StackCount<R>::value, false);
             //恢复调用前的堆栈索引
             lua_settop(L, m_iTopIndex);
             return r;
@@ -269,7 +430,7 @@ R LuaBridge::SafeEndCall(const char *func, int nArg)
             //恢复调用前的堆栈索引
             lua_settop(L, m_iTopIndex);
             LuaHelper::DebugCallFuncErrorStack(L, func, e.what());
-            return 0;
+            return R();
         }
     }
 }
@@ -292,6 +453,46 @@ R LuaBridge::CallLuaFunc(const char *func, const Args... args)
     return SafeEndCall<R, 0>(func, sizeof...(args));
 }
 
+template<typename Iter>
+bool LuaBridge::CallForEach(const char *func, Iter begin, Iter end)
+{
+    lua_State *L = m_pLuaVm->LuaState();
+    int top = lua_gettop(L);
+    ForEachCall<Iter> call = {func, begin, end};
+    lua_pushcfunction(L, &ForEachCall<Iter>::Run);
+    lua_pushlightuserdata(L, &call);
+    bool ok = true;
+    if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+        LuaHelper::DebugCallFuncErrorStack(L, func, lua_tostring(L, -1));
+        ok = false;
+    }
+    lua_settop(L, top);
+    return ok;
+}
+
+template<typename Iter>
+bool LuaBridge::CallWithRange(const char *func, Iter begin, Iter end)
+{
+    lua_State *L = m_pLuaVm->LuaState();
+    int top = lua_gettop(L);
+    lua_getglobal(L, func);
+    RangeView<Iter> *view = RangeView<Iter>::push(L, begin, end);
+    bool ok = true;
+    if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+        LuaHelper::DebugCallFuncErrorStack(L, func, lua_tostring(L, -1));
+        ok = false;
+    }
+    view->Invalidate();
+    lua_settop(L, top);
+    return ok;
+}
+
+template<typename FT>
+LuaFunction<FT> LuaBridge::GetLuaFunction(const char *func)
+{
+    return LuaFunction<FT>(m_pLuaVm->LuaState(), func);
+}
+
 const char *LuaBridge::Call(const char *func, const char *sig, ...)
 {
     lua_State *L = m_pLuaVm->LuaState();
@@ -396,13 +597,23 @@ const char *LuaBridge::Call(const char *func, const char *sig, ...)
 template<typename T>
 int LuaBridge::PushSharedObjToLua(lua_State *L, std::shared_ptr<T> ptr)
 {
-    new(lua_newuserdata(L, sizeof(UserdataShared<std::shared_ptr<T>>))) UserdataShared<std::shared_ptr<T>>(ptr);
-    lua_rawgetp(L, LUA_REGISTRYINDEX, ClassInfo<T>::GetClassKey());
-    LUA_ASSERT(L, lua_istable(L, -1), "UserdataSharedHelper::push<T*> lua_istable failed");
-    lua_setmetatable(L, -2);
+    if (Userdata::PushCachedOrMetatable(L, ClassInfo<T>::GetClassKey(), ptr.get())) {
+        return 1;
+    }
+    Userdata::EnsureGcMetaMethod<T>(L);
+    UserdataShared<std::shared_ptr<T>> *ud =
+        new(lua_newuserdata(L, sizeof(UserdataShared<std::shared_ptr<T>>))) UserdataShared<std::shared_ptr<T>>(ptr);
+    ud->SetType(ClassInfo<T>::GetTypeInfo(), false);
+    ud->Created(sizeof(UserdataShared<std::shared_ptr<T>>));
+    Userdata::SetMetatable(L, ptr.get());
     return 1;
 }
 
+void LuaBridge::RegisterClassStats(const char *name)
+{
+    lua_register(m_pLuaVm->LuaState(), name, &CFunc::ClassStats);
+}
+
 Namespace &LuaBridge::BeginNameSpace(char *name)
 {
     m_namespace = GetGlobalNamespace().BeginNamespace(name);;
@@ -424,8 +635,11 @@ void LuaBridge::EndNamespace()
 
 Namespace &LuaBridge::GetGlobalNamespace()
 {
-    static Namespace g_namespace(m_pLuaVm);
-    return g_namespace;
+    // One per LuaBridge, each instance has its own lua_State
+    if (!m_globalNamespace.IsValid()) {
+        m_globalNamespace = Namespace(m_pLuaVm);
+    }
+    return m_globalNamespace;
 }
 
 lua_State *LuaBridge::LuaState()
@@ -445,6 +659,9 @@ Namespace &LuaBridge::CurNameSpace()
         LuaBridge& _luabridge_ = luabridge;                                             \
         _luabridge_.BeginNameSpace(name);
 
+#define NAMESPACE_ADD_CONSTANT(name, value)                                             \
+        _luabridge_.CurNameSpace().AddConstant(name, value);
+
 #define END_NAMESPACE                                                                   \
         _luabridge_.EndNamespace();                                                     \
     }
@@ -478,12 +695,36 @@ Namespace &LuaBridge::CurNameSpace()
  * */
 #define BEGIN_SHARED_CLASS(luabridge, ClassT) BEGIN_CLASS_SHARED_OR_NOT(luabridge, ClassT,true)
 
+#define CLASS_FLAT_DISPATCH                                                             \
+        pclasst->EnableFlatDispatch();
+
+#define CLASS_IDENTITY_CACHE                                                            \
+        pclasst->EnableIdentityCache();
+
+#define CLASS_ENABLE_STATS                                                              \
+        pclasst->EnableStats();
+
 #define CLASS_ADD_CONSTRUCTOR(FT)                                                       \
         pclasst->AddConstructor<FT>();
 
 #define CLASS_ADD_FUNC(name, func)                                                      \
         pclasst->AddFunction(name, func);
 
+/*
+ * 编译期绑定成员函数,func必须是常量成员函数指针(如&ClassT::Func),没有upvalue
+ * */
+#define CLASS_ADD_FUNC_T(name, func)                                                    \
+        pclasst->AddFunction<decltype(func), func>(name);
+
+/*
+ * 编译期绑定数据成员,data必须是常量成员指针(如&ClassT::m_data)
+ * */
+#define CLASS_ADD_DATA_T(name, data)                                                    \
+        pclasst->AddData<decltype(data), data>(name);
+
+#define CLASS_ADD_CONSTANT(name, value)                                                 \
+        pclasst->AddConstant(name, value);
+
 #define CLASS_ADD_STATIC_PROPERTY(name, data)                                           \
         pclasst->AddStaticProperty(name, data,true);
 
@@ -491,6 +732,22 @@ Namespace &LuaBridge::CurNameSpace()
         pclasst->EndClass();                                                            \
     }
 
+/*
+ * 在当前命名空间(没有则是全局)中注册枚举
+ * */
+#define BEGIN_ENUM(luabridge, EnumT)                                                    \
+    {                                                                                   \
+        Enum<EnumT> enumt = luabridge.CurNameSpace().IsValid()                          \
+            ? luabridge.CurNameSpace().BeginEnum<EnumT>(#EnumT)                         \
+            : luabridge.GetGlobalNamespace().BeginEnum<EnumT>(#EnumT);
+
+#define ENUM_ADD_VALUE(name, value)                                                     \
+        enumt.AddValue(name, value);
+
+#define END_ENUM                                                                        \
+        enumt.EndEnum();                                                                \
+    }
+
 #define BEGIN_REGISTER_CFUNC(luabridge)                                                 \
     {                                                                                   \
         LuaBridge& _luabridge_ = luabridge;
@@ -505,6 +762,19 @@ Namespace &LuaBridge::CurNameSpace()
              _luabridge_.CurNameSpace().AddCFunction(name,func);                        \
         }
 
+/*
+ * 编译期绑定函数,func必须是常量函数指针(如&Add),调用时直接调用目标函数,没有静态函数槽
+ * */
+#define REGISTER_CFUNC_T(name, func)                                                    \
+        if(!_luabridge_.CurNameSpace().IsValid())                                       \
+        {                                                                               \
+            Namespace::AddGlobalCFunc<decltype(func), func>(_luabridge_.LuaState(),name); \
+        }                                                                               \
+        else                                                                            \
+        {                                                                               \
+             _luabridge_.CurNameSpace().AddCFunction<decltype(func), func>(name);       \
+        }
+
 #define END_REGISTER_CFUNC                                                              \
     }
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
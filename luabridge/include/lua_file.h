@@ -45,5 +45,13 @@
 #include "core/lua_vm.h"
 #include "core/caller.h"
 #include "core/lua_class.h"
+#include "core/lua_buffer.h"
+#include "core/lua_function_ref.h"
+#include "core/lua_batch.h"
+#include "core/lua_allocator.h"
+#include "core/lua_enum.h"
+#include "core/lua_bytecode_cache.h"
+#include "core/lua_bundle.h"
+#include "core/lua_schema.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,659 @@
+//------------------------------------------------------------------------------
+/*
+  https://github.com/DGuco/luabridge
+
+  Copyright (C) 2021 DGuco(杜国超)<1139140929@qq.com>.  All rights reserved.
+
+  License: The MIT License (http://www.opensource.org/licenses/mit-license.php)
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef __LUA_STATE_POOL_H__
+#define __LUA_STATE_POOL_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "lua_bridge.h"
+
+namespace luabridge
+{
+
+/**
+ * 预先初始化好的lua_State池,供工作线程按请求取用
+ *
+ * Every state is built once by the init function (registration, LoadFile,
+ * ...) and reused. Acquire and Release are lock-free on the fast path:
+ * idle states sit in a fixed array of atomic slots. When no state is idle
+ * the pool grows up to maxSize, the new state is built on the acquiring
+ * thread outside the pool lock. At maxSize, Acquire blocks until another thread
+ * returns a state. Registration writes process wide statics (class hierarchy,
+ * REGISTER_CFUNC slots), so the init functions of all pools run one at a time;
+ * an init that only calls ReplaySchema and loads scripts holds that lock for
+ * the shortest time. Don't register on other threads while a pool grows, and
+ * don't REGISTER_CFUNC a std::function in init: its slot is rewritten on every
+ * registration while other states call it, use REGISTER_CFUNC_T instead.
+ * Shrink () drops idle states above minSize, call it from a maintenance timer
+ * once load goes down.
+ *
+ * Per request state:
+ *  - Chunks run through Handle::DoString / DoFile get a fresh _ENV table for
+ *    the request, reading through to _G. Their globals go to that table,
+ *    which is dropped on release.
+ *  - Globals written by functions defined at init (their _ENV is _G) are
+ *    undone on release: _G is restored to what it was right after init.
+ *  - Anything else a request changes (tables reachable from _G, loaded
+ *    modules, metatables, the registry) stays in the state. Set maxUses to
+ *    rebuild a state after that many requests, maxUses = 1 gives every
+ *    request a fresh state. The replacement is built on the releasing
+ *    thread, not on the next Acquire.
+ * A state that fails to reset (e.g. out of memory) is destroyed instead of
+ * being reused.
+ *
+ * A state is used by one thread at a time. All handles must be released
+ * before the pool is destroyed.
+ *
+ * Sample:  BindingSchema schema;
+ *          LuaBridge::RecordSchema(schema, RegisterAll);
+ *          LuaStatePool pool([&](LuaBridge &lua) {
+ *              lua.ReplaySchema(schema);
+ *              lua.LoadFile("main.lua");
+ *          }, 4, 16, 1000);
+ *          // worker thread
+ *          LuaStatePool::Handle lua = pool.Acquire();
+ *          lua->CallLuaFunc<int>("on_request", id);
+ */
+class LuaStatePool
+{
+private:
+    LuaStatePool(const LuaStatePool &);
+    LuaStatePool &operator=(const LuaStatePool &);
+
+    struct PooledState
+    {
+        PooledState()
+            : top(0), uses(0), env(LUA_NOREF)
+        {
+        }
+
+        LuaBridge lua;
+        int top;        // stack top after init
+        size_t uses;    // requests served
+        int env;        // registry reference of the request _ENV
+    };
+
+public:
+    typedef std::function<void(LuaBridge &)> InitFunction;
+
+    /**
+     * Counters since the pool was created, wait times in nanoseconds.
+     */
+    struct Stats
+    {
+        size_t live;        // states created and not destroyed
+        size_t idle;        // states waiting in the pool
+        size_t acquires;
+        size_t waits;       // acquires that blocked because the pool was at maxSize
+        size_t created;
+        size_t destroyed;
+        size_t recycled;    // destroyed after maxUses requests or a failed reset
+        unsigned long long totalWaitNs;
+        unsigned long long maxWaitNs;
+    };
+
+    /**
+     * RAII handle of an acquired state, gives it back to the pool when destroyed.
+     */
+    class Handle
+    {
+    private:
+        Handle(const Handle &);
+        Handle &operator=(const Handle &);
+
+    public:
+        Handle()
+            : m_pPool(NULL), m_pState(NULL)
+        {
+        }
+
+        Handle(Handle &&other)
+            : m_pPool(other.m_pPool), m_pState(other.m_pState)
+        {
+            other.m_pState = NULL;
+        }
+
+        Handle &operator=(Handle &&other)
+        {
+            if (this != &other) {
+                Release();
+                m_pPool = other.m_pPool;
+                m_pState = other.m_pState;
+                other.m_pState = NULL;
+            }
+            return *this;
+        }
+
+        ~Handle()
+        {
+            Release();
+        }
+
+        LuaBridge &operator*() const
+        {
+            return m_pState->lua;
+        }
+
+        LuaBridge *operator->() const
+        {
+            return &m_pState->lua;
+        }
+
+        LuaBridge *Get() const
+        {
+            return m_pState != NULL ? &m_pState->lua : NULL;
+        }
+
+        bool IsValid() const
+        {
+            return m_pState != NULL;
+        }
+
+        /**
+         * Push the _ENV table of this request, created on first use.
+         */
+        void PushEnvironment()
+        {
+            lua_State *L = m_pState->lua.LuaState();
+            if (m_pState->env == LUA_NOREF) {
+                lua_newtable(L); // Stack: env
+                lua_rawgetp(L, LUA_REGISTRYINDEX, GetEnvMetatableKey()); // Stack: env, mt
+                lua_setmetatable(L, -2); // Stack: env
+                m_pState->env = luaL_ref(L, LUA_REGISTRYINDEX); // Stack: -
+            }
+            lua_rawgeti(L, LUA_REGISTRYINDEX, m_pState->env); // Stack: env
+        }
+
+        /**
+         * Run a chunk with the request _ENV.
+         * @return LUA_OK, or an error code with the message on the stack
+         */
+        int DoString(const char *code, const char *chunkname = NULL)
+        {
+            lua_State *L = m_pState->lua.LuaState();
+            int ret = luaL_loadbufferx(L, code, strlen(code), chunkname != NULL ? chunkname : code, NULL);
+            return ret != LUA_OK ? ret : RunChunk(L);
+        }
+
+        /**
+         * Run a script file with the request _ENV.
+         * @return LUA_OK, or an error code with the message on the stack
+         */
+        int DoFile(const char *path)
+        {
+            lua_State *L = m_pState->lua.LuaState();
+            int ret = luaL_loadfilex(L, path, NULL);
+            return ret != LUA_OK ? ret : RunChunk(L);
+        }
+
+        /**
+         * Give the state back before the handle goes out of scope.
+         */
+        void Release()
+        {
+            if (m_pState != NULL) {
+                m_pPool->Release(m_pState);
+                m_pState = NULL;
+            }
+        }
+
+    private:
+        friend class LuaStatePool;
+
+        Handle(LuaStatePool *pool, PooledState *state)
+            : m_pPool(pool), m_pState(state)
+        {
+        }
+
+        int RunChunk(lua_State *L)
+        {
+            PushEnvironment(); // Stack: chunk, env
+            // The first upvalue of a main chunk is _ENV
+            if (lua_setupvalue(L, -2, 1) == NULL) {
+                lua_pop(L, 1);
+            }
+            return lua_pcall(L, 0, LUA_MULTRET, 0);
+        }
+
+    private:
+        LuaStatePool *m_pPool;
+        PooledState *m_pState;
+    };
+
+    /**
+     * @param init      builds a state, runs once per state on the thread that creates it
+     * @param minSize   states created up front and kept by Shrink ()
+     * @param maxSize   upper bound of live states
+     * @param maxUses   rebuild a state after this many requests, 0 never
+     */
+    LuaStatePool(const InitFunction &init, size_t minSize, size_t maxSize, size_t maxUses = 0)
+        : m_init(init), m_minSize(minSize), m_maxUses(maxUses), m_slots(maxSize), m_live(0), m_idle(0),
+          m_waiters(0), m_acquires(0), m_waits(0), m_created(0), m_destroyed(0), m_recycled(0),
+          m_totalWaitNs(0), m_maxWaitNs(0)
+    {
+        if (maxSize == 0 || minSize > maxSize) {
+            throw std::logic_error("LuaStatePool needs 0 < maxSize and minSize <= maxSize");
+        }
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            m_slots[i].store(NULL, std::memory_order_relaxed);
+        }
+        try {
+            for (size_t i = 0; i < minSize; ++i) {
+                m_live.fetch_add(1, std::memory_order_relaxed);
+                Push(Create());
+            }
+        }
+        catch (...) {
+            DestroyIdle();
+            throw;
+        }
+    }
+
+    ~LuaStatePool()
+    {
+        DestroyIdle();
+    }
+
+    /**
+     * Take an idle state, create one if the pool is below maxSize, otherwise wait for a release.
+     */
+    Handle Acquire()
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        PooledState *state = Pop();
+        if (state == NULL && Reserve()) {
+            state = Create();
+        }
+        if (state == NULL) {
+            m_waits.fetch_add(1, std::memory_order_relaxed);
+            state = Wait();
+        }
+        m_acquires.fetch_add(1, std::memory_order_relaxed);
+        RecordWait(std::chrono::steady_clock::now() - start);
+        return Handle(this, state);
+    }
+
+    /**
+     * Take an idle state without creating or waiting.
+     * @return an invalid handle if no state is idle
+     */
+    Handle TryAcquire()
+    {
+        PooledState *state = Pop();
+        if (state != NULL) {
+            m_acquires.fetch_add(1, std::memory_order_relaxed);
+        }
+        return Handle(this, state);
+    }
+
+    /**
+     * Destroy idle states until the pool is down to minSize live states.
+     * @return number of states destroyed
+     */
+    size_t Shrink()
+    {
+        size_t count = 0;
+        size_t live = m_live.load(std::memory_order_relaxed);
+        while (live > m_minSize) {
+            if (!m_live.compare_exchange_weak(live, live - 1, std::memory_order_relaxed)) {
+                continue;
+            }
+            PooledState *state = Pop();
+            if (state == NULL) {
+                m_live.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            delete state;
+            m_destroyed.fetch_add(1, std::memory_order_relaxed);
+            ++count;
+            live = m_live.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    Stats GetStats() const
+    {
+        Stats stats;
+        stats.live = m_live.load(std::memory_order_relaxed);
+        stats.idle = m_idle.load(std::memory_order_relaxed);
+        stats.acquires = m_acquires.load(std::memory_order_relaxed);
+        stats.waits = m_waits.load(std::memory_order_relaxed);
+        stats.created = m_created.load(std::memory_order_relaxed);
+        stats.destroyed = m_destroyed.load(std::memory_order_relaxed);
+        stats.recycled = m_recycled.load(std::memory_order_relaxed);
+        stats.totalWaitNs = m_totalWaitNs.load(std::memory_order_relaxed);
+        stats.maxWaitNs = m_maxWaitNs.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    size_t MaxSize() const
+    {
+        return m_slots.size();
+    }
+
+    size_t MinSize() const
+    {
+        return m_minSize;
+    }
+
+private:
+    /**
+     * Build a state, m_live has already been raised for it by Reserve ().
+     */
+    PooledState *Create()
+    {
+        PooledState *state = NULL;
+        try {
+            state = new PooledState();
+            {
+                std::lock_guard<std::mutex> lock(InitMutex());
+                m_init(state->lua);
+            }
+            lua_State *L = state->lua.LuaState();
+            state->top = lua_gettop(L);
+            SnapshotGlobals(L);
+        }
+        catch (...) {
+            delete state;
+            m_live.fetch_sub(1, std::memory_order_relaxed);
+            NotifyWaiters();
+            throw;
+        }
+        m_created.fetch_add(1, std::memory_order_relaxed);
+        return state;
+    }
+
+    /**
+     * Serializes the init functions of every pool.
+     */
+    static std::mutex &InitMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /**
+     * Count a new state if the pool is below maxSize.
+     */
+    bool Reserve()
+    {
+        size_t live = m_live.load(std::memory_order_relaxed);
+        while (live < m_slots.size()) {
+            if (m_live.compare_exchange_weak(live, live + 1, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Block until a state is released or the pool can grow again, the state is built after unlocking.
+     */
+    PooledState *Wait()
+    {
+        PooledState *state = NULL;
+        bool reserved = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // Seen by Release () after it publishes a state, or this Pop sees the state
+            m_waiters.fetch_add(1);
+            while ((state = Pop()) == NULL && !(reserved = Reserve())) {
+                m_cond.wait(lock);
+            }
+            m_waiters.fetch_sub(1);
+        }
+        return reserved ? Create() : state;
+    }
+
+    void NotifyWaiters()
+    {
+        if (m_waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cond.notify_one();
+        }
+    }
+
+    /**
+     * Runs in ~Handle, nothing may escape.
+     */
+    void Release(PooledState *state)
+    {
+        ++state->uses;
+        if ((m_maxUses == 0 || state->uses < m_maxUses) && Reset(state)) {
+            Push(state);
+            NotifyWaiters();
+            return;
+        }
+
+        // Rebuild the state here rather than on the next Acquire
+        delete state;
+        m_destroyed.fetch_add(1, std::memory_order_relaxed);
+        m_recycled.fetch_add(1, std::memory_order_relaxed);
+        try {
+            Push(Create());
+        }
+        catch (...) {
+            // Create () gave the slot back, Acquire grows again later
+            return;
+        }
+        NotifyWaiters();
+    }
+
+    PooledState *Pop()
+    {
+        if (m_idle.load() == 0) {
+            return NULL;
+        }
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].load() == NULL) {
+                continue;
+            }
+            PooledState *state = m_slots[i].exchange(NULL);
+            if (state != NULL) {
+                m_idle.fetch_sub(1);
+                return state;
+            }
+        }
+        return NULL;
+    }
+
+    /**
+     * There is always a free slot, live states never exceed the slot count.
+     */
+    void Push(PooledState *state)
+    {
+        // Counted before it is published, so a concurrent Pop never takes idle below 0
+        m_idle.fetch_add(1);
+        for (;;) {
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                PooledState *expected = NULL;
+                if (m_slots[i].compare_exchange_strong(expected, state)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    void DestroyIdle()
+    {
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            delete m_slots[i].exchange(NULL, std::memory_order_acquire);
+        }
+    }
+
+    static void const *GetGlobalsKey()
+    {
+        static char value;
+        return &value;
+    }
+
+    static void const *GetEnvMetatableKey()
+    {
+        static char value;
+        return &value;
+    }
+
+    /**
+     * Keep a shallow copy of _G in the registry, Reset () restores it. Also
+     * creates the metatable of the request _ENV tables.
+     */
+    static void SnapshotGlobals(lua_State *L)
+    {
+        lua_newtable(L); // Stack: copy
+        lua_pushglobaltable(L); // Stack: copy, _G
+        lua_pushnil(L);
+        while (lua_next(L, -2)) // Stack: copy, _G, key, value
+        {
+            lua_pushvalue(L, -2); // Stack: copy, _G, key, value, key
+            lua_insert(L, -2); // Stack: copy, _G, key, key, value
+            lua_rawset(L, -5); // Stack: copy, _G, key
+        }
+        lua_pop(L, 1); // Stack: copy
+        lua_rawsetp(L, LUA_REGISTRYINDEX, GetGlobalsKey()); // Stack: -
+
+        lua_createtable(L, 0, 1); // Stack: mt
+        lua_pushglobaltable(L); // Stack: mt, _G
+        LuaHelper::RawSetField(L, -2, "__index"); // Stack: mt
+        lua_rawsetp(L, LUA_REGISTRYINDEX, GetEnvMetatableKey()); // Stack: -
+    }
+
+    /**
+     * Undo what a request did, in protected mode since it can raise a memory error.
+     * @return false if the state can't be reused
+     */
+    static bool Reset(PooledState *state)
+    {
+        lua_State *L = state->lua.LuaState();
+        if (lua_gettop(L) > state->top) {
+            lua_settop(L, state->top);
+        }
+        try {
+            if (!lua_checkstack(L, 2)) {
+                return false;
+            }
+            lua_pushcfunction(L, &LuaStatePool::ResetState);
+            lua_pushlightuserdata(L, state);
+            if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+                lua_settop(L, state->top);
+                return false;
+            }
+        }
+        catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    static int ResetState(lua_State *L)
+    {
+        PooledState *state = static_cast<PooledState *>(lua_touserdata(L, 1));
+        lua_settop(L, 0);
+        luaL_unref(L, LUA_REGISTRYINDEX, state->env);
+        state->env = LUA_NOREF;
+
+        lua_rawgetp(L, LUA_REGISTRYINDEX, GetGlobalsKey()); // Stack: copy
+        lua_pushglobaltable(L); // Stack: copy, _G
+
+        // Remove the globals added or changed, keys can't be set to nil during lua_next
+        lua_newtable(L); // Stack: copy, _G, removed
+        lua_pushnil(L);
+        while (lua_next(L, -3)) // Stack: copy, _G, removed, key, value
+        {
+            lua_pushvalue(L, -2); // Stack: copy, _G, removed, key, value, key
+            lua_rawget(L, -6); // Stack: copy, _G, removed, key, value, old
+            bool same = lua_rawequal(L, -1, -2) != 0;
+            lua_pop(L, 2); // Stack: copy, _G, removed, key
+            if (!same) {
+                lua_pushvalue(L, -1);
+                lua_pushboolean(L, 1);
+                lua_rawset(L, -4); // Stack: copy, _G, removed, key
+            }
+        }
+        lua_pushnil(L);
+        while (lua_next(L, -2)) // Stack: copy, _G, removed, key, true
+        {
+            lua_pop(L, 1);
+            lua_pushvalue(L, -1);
+            lua_pushnil(L);
+            lua_rawset(L, -5); // Stack: copy, _G, removed, key
+        }
+        lua_pop(L, 1); // Stack: copy, _G
+
+        // Put back the init globals that were changed or removed
+        lua_pushnil(L);
+        while (lua_next(L, -3)) // Stack: copy, _G, key, value
+        {
+            lua_pushvalue(L, -2); // Stack: copy, _G, key, value, key
+            lua_insert(L, -2); // Stack: copy, _G, key, key, value
+            lua_rawset(L, -4); // Stack: copy, _G, key
+        }
+        lua_pop(L, 2); // Stack: -
+        lua_gc(L, LUA_GCSTEP, 0);
+        return 0;
+    }
+
+    void RecordWait(std::chrono::steady_clock::duration wait)
+    {
+        unsigned long long ns = static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count());
+        m_totalWaitNs.fetch_add(ns, std::memory_order_relaxed);
+        unsigned long long max = m_maxWaitNs.load(std::memory_order_relaxed);
+        while (ns > max && !m_maxWaitNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+private:
+    InitFunction m_init;
+    size_t m_minSize;
+    size_t m_maxUses;
+    std::vector<std::atomic<PooledState *> > m_slots;
+    std::atomic<size_t> m_live;
+    std::atomic<size_t> m_idle;
+    std::atomic<int> m_waiters;
+    std::atomic<size_t> m_acquires;
+    std::atomic<size_t> m_waits;
+    std::atomic<size_t> m_created;
+    std::atomic<size_t> m_destroyed;
+    std::atomic<size_t> m_recycled;
+    std::atomic<unsigned long long> m_totalWaitNs;
+    std::atomic<unsigned long long> m_maxWaitNs;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+};
+
+} // namespace luabridge
+
+#endif